@@ -0,0 +1,23 @@
+#include "arena.h"
+#include <algorithm>
+using namespace std;
+
+// do_allocate bumps within the current block, moving on to the next block (allocated on first
+// use) when the request does not fit.
+void* ScratchArena::do_allocate(size_t bytes, size_t alignment) {
+    for (;;) {
+        if (current < storage.size()) {
+            Block& block = storage[current];
+            size_t start = (used + alignment - 1) & ~(alignment - 1);
+            if (start + bytes <= block.Size) {
+                used = start + bytes;
+                return block.Data.get() + start;
+            }
+            current++;
+            used = 0;
+            continue;
+        }
+        size_t size = max(BlockBytes, bytes + alignment);
+        storage.push_back({unique_ptr<byte[]>(new byte[size]), size});
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// ScratchArena is a per-worker bump allocator for search temporaries. deallocate does nothing;
+// memory comes back all at once when a ScratchScope ends, so a search node frees everything its
+// subtree allocated in one step. Blocks are kept, so a warm arena never calls malloc.
+class ScratchArena : public std::pmr::memory_resource {
+    public:
+        static constexpr size_t BlockBytes = 64u << 10;
+
+        // Mark is a position in the arena, see ScratchScope.
+        struct Mark {
+            size_t Block = 0;
+            size_t Used = 0;
+        };
+
+        ScratchArena() = default;
+        ScratchArena(const ScratchArena&) = delete;
+        ScratchArena& operator=(const ScratchArena&) = delete;
+
+        Mark mark() const {
+            return {current, used};
+        }
+        void rewind(Mark m) {
+            current = m.Block;
+            used = m.Used;
+        }
+        // release rewinds to the start and keeps the blocks.
+        void release() {
+            rewind(Mark());
+        }
+        size_t blocks() const {
+            return storage.size();
+        }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+    private:
+        struct Block {
+            std::unique_ptr<std::byte[]> Data;
+            size_t Size = 0;
+        };
+        std::vector<Block> storage;
+        size_t current = 0;
+        size_t used = 0;
+};
+
+// ScratchScope rewinds the arena to where it was when the scope began. A null arena is allowed
+// and does nothing, for boards searched outside a SolverContext.
+class ScratchScope {
+    public:
+        explicit ScratchScope(ScratchArena* arena) : arena(arena) {
+            if (arena != nullptr) {
+                start = arena->mark();
+            }
+        }
+        ScratchScope(const ScratchScope&) = delete;
+        ScratchScope& operator=(const ScratchScope&) = delete;
+        ~ScratchScope() {
+            if (arena != nullptr) {
+                arena->rewind(start);
+            }
+        }
+
+    private:
+        ScratchArena* arena;
+        ScratchArena::Mark start;
+};
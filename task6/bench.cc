@@ -0,0 +1,302 @@
+#include "board.h"
+#include "bitboard.h"
+#include "combination.h"
+#include "initalBoards.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <vector>
+using namespace std;
+
+// Every heap allocation of the benchmark goes through these, so allocations can be counted.
+static atomic<uint64_t> heapAllocations{0};
+
+__attribute__((noinline)) static void* countedAlloc(size_t bytes, size_t alignment = 0) {
+    heapAllocations.fetch_add(1, memory_order_relaxed);
+    bytes = bytes != 0 ? bytes : 1;
+    void* p = alignment > 0 ? aligned_alloc(alignment, (bytes + alignment - 1) / alignment * alignment) : malloc(bytes);
+    if (p == nullptr) {
+        throw bad_alloc();
+    }
+    return p;
+}
+
+__attribute__((noinline)) static void countedFree(void* p) {
+    free(p);
+}
+
+void* operator new(size_t bytes) {
+    return countedAlloc(bytes);
+}
+
+void operator delete(void* p) noexcept {
+    countedFree(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    countedFree(p);
+}
+
+// std::pmr::new_delete_resource allocates through the aligned forms.
+void* operator new(size_t bytes, align_val_t alignment) {
+    return countedAlloc(bytes, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* p, align_val_t) noexcept {
+    countedFree(p);
+}
+
+void operator delete(void* p, size_t, align_val_t) noexcept {
+    countedFree(p);
+}
+
+// Microbenchmarks of the solver kernels on random black cell sets of the built-in boards.
+// Build and run with `make bench`.
+
+namespace {
+
+// randomStates returns boards with random non-adjacent black cells, about one cell in five.
+vector<Board> randomStates(const Board& board, int count, mt19937& rng) {
+    vector<Board> res;
+    for (int k = 0; k < count; ++k) {
+        Board state = board.copy();
+        state.cleanFilled();
+        for (size_t i = 0; i < state.Cells.size(); ++i) {
+            if (rng() % 5 == 0 && !state.nextToFilled(state.Cells[i])) {
+                vector<int> filled = state.filledIndexes();
+                filled.push_back(static_cast<int>(i));
+                state.setFilled(filled);
+            }
+        }
+        res.push_back(state);
+    }
+    return res;
+}
+
+template <typename F>
+double nsPerCall(int calls, F f) {
+    auto start = chrono::steady_clock::now();
+    for (int c = 0; c < calls; ++c) {
+        f(c);
+    }
+    chrono::duration<double, nano> d = chrono::steady_clock::now() - start;
+    return d.count() / calls;
+}
+
+void benchWhiteLines(vector<Board>& states) {
+    const int calls = 20000;
+    int agree = 0;
+    for (auto& state : states) {
+        bool bfs = state.checkWhiteLinesBfs();
+        Bitboard white = state.whiteCells();
+        agree += (bfs == whiteConnectedPortable(white) && bfs == whiteConnectedAvx2(white)) ? 1 : 0;
+    }
+    volatile bool sink = false;
+    double bfs = nsPerCall(calls, [&](int c) { sink = states[c % states.size()].checkWhiteLinesBfs(); });
+    vector<Bitboard> whites;
+    for (const auto& state : states) {
+        whites.push_back(state.whiteCells());
+    }
+    double portable = nsPerCall(calls, [&](int c) { sink = whiteConnectedPortable(whites[c % whites.size()]); });
+    double avx2 = nsPerCall(calls, [&](int c) { sink = whiteConnectedAvx2(whites[c % whites.size()]); });
+    (void)sink;
+    cout << "  white connectivity: bfs " << bfs << " ns, portable " << portable << " ns, ";
+    if (hasAvx2()) {
+        cout << "avx2 " << avx2 << " ns, ";
+    }
+    cout << "agree " << agree << "/" << states.size() << endl;
+}
+
+// benchRuns times the three-room rule: the old walks over Cells against the border mask kernels.
+// The walks only check the last row and do not end runs at holes, so only the kernels are compared.
+void benchRuns(vector<Board>& states) {
+    const int calls = 20000;
+    int agree = 0;
+    for (auto& state : states) {
+        Bitboard white = state.whiteCells();
+        agree += longRunRowPortable(white, state.RowBorders) == longRunRowAvx2(white, state.RowBorders) ? 1 : 0;
+    }
+    volatile int sink = 0;
+    double walk = nsPerCall(calls, [&](int c) {
+        const Board& state = states[c % states.size()];
+        sink = state.checkHorizontalWhiteWalk() + state.checkVerticalWhiteWalk();
+    });
+    auto kernel = [&](int (*rowKernel)(const Bitboard&, const Bitboard&)) {
+        return nsPerCall(calls, [&](int c) {
+            const Board& state = states[c % states.size()];
+            Bitboard white = state.whiteCells();
+            sink = rowKernel(white, state.RowBorders) + longRunCol(white, state.ColBorders);
+        });
+    };
+    double portable = kernel(longRunRowPortable);
+    double avx2 = kernel(longRunRowAvx2);
+    (void)sink;
+    cout << "  three-room runs: walk " << walk << " ns, portable " << portable << " ns, ";
+    if (hasAvx2()) {
+        cout << "avx2 " << avx2 << " ns, ";
+    }
+    cout << "agree " << agree << "/" << states.size() << endl;
+}
+
+// benchKernels compares the kernels the board dispatches to with the dynamic ones.
+void benchKernels(vector<Board>& states) {
+    const int calls = 20000;
+    const BoardKernels& fixed = *states[0].Kernels;
+    const BoardKernels& dynamic = boardKernels(Bitboard::MaxRows, Bitboard::MaxCols);
+    if (fixed.Rows == 0) {
+        cout << "  no specialization for this size" << endl;
+        return;
+    }
+    int agree = 0;
+    for (auto& state : states) {
+        Bitboard white = state.whiteCells();
+        bool same = fixed.Connected(white) == dynamic.Connected(white) &&
+            fixed.LongRunRow(white, state.RowBorders) == dynamic.LongRunRow(white, state.RowBorders) &&
+            fixed.LongRunCol(white, state.ColBorders) == dynamic.LongRunCol(white, state.ColBorders);
+        agree += same ? 1 : 0;
+    }
+    volatile int sink = 0;
+    auto time = [&](const BoardKernels& kernels) {
+        return nsPerCall(calls, [&](int c) {
+            const Board& state = states[c % states.size()];
+            Bitboard white = state.whiteCells();
+            sink = kernels.Connected(white) + kernels.LongRunRow(white, state.RowBorders) +
+                kernels.LongRunCol(white, state.ColBorders);
+        });
+    };
+    double dynamicNs = time(dynamic);
+    double fixedNs = time(fixed);
+    (void)sink;
+    cout << "  all checks: dynamic " << dynamicNs << " ns, Solver<" << fixed.Rows << ", " << fixed.Cols << "> "
+        << fixedNs << " ns, agree " << agree << "/" << states.size() << endl;
+}
+
+// searchAllocations runs fill on the first leaf combinations of board that get as far as the
+// search and returns the heap allocations per search node, with the given scratch arena or none.
+// Without an arena the scratch vectors fall back to the heap; the walk keeps its frames for the
+// whole fill, so this measures the current search on the heap, not the recursive search the
+// arena first replaced. Returns -1 if there is no such leaf among the first combinations.
+double searchAllocations(const Board& board, ScratchArena* arena) {
+    vector<vector<Cell>> leaves;
+    atomic<bool> stop{false};
+    Board probe = board.copy();
+    int scanned = 0;
+    generateCombs(stop, board.Sectors, board.Cells, [&](const vector<Cell> comb) {
+        probe.cleanFilled();
+        bool ok = true;
+        for (const auto& cell : comb) {
+            ok = ok && probe.add(probe.cellIndex(cell.i, cell.j));
+        }
+        if (ok) {
+            leaves.push_back(comb);
+        }
+        if (leaves.size() == 64 || ++scanned == 100000) {
+            stop.store(true);
+        }
+    });
+    if (leaves.empty()) {
+        return -1;
+    }
+    Board state = board.copy();
+    SearchProgress progress;
+    progress.NodeBudget = 20000;
+    state.Progress = &progress;
+    state.Scratch = arena;
+    // fill runs the leaves until the node budget cancels it; the first pass warms up the arena.
+    auto pass = [&]() {
+        atomic<bool> cancel{false};
+        progress.Nodes.store(0);
+        for (const auto& leaf : leaves) {
+            if (cancel.load()) {
+                break;
+            }
+            state.fill(cancel, leaf, true);
+        }
+        return progress.Nodes.load();
+    };
+    pass();
+    uint64_t before = heapAllocations.load();
+    uint64_t nodes = pass();
+    return nodes > 0 ? double(heapAllocations.load() - before) / nodes : 0;
+}
+
+void benchAllocations(const Board& board) {
+    ScratchArena arena;
+    double heap = searchAllocations(board, nullptr);
+    double scratch = searchAllocations(board, &arena);
+    if (heap < 0) {
+        cout << "  heap allocations: no early leaf reaches the search" << endl;
+        return;
+    }
+    cout << "  heap allocations per search node: " << heap << " with heap scratch, " << scratch << " with arena" << endl;
+}
+
+// benchLargeWhite times the bitboard kernels on random 64x64 grids, where a BFS over Cells is impractical.
+void benchLargeWhite(mt19937& rng) {
+    const int calls = 2000;
+    vector<Bitboard> whites(16);
+    int agree = 0;
+    for (auto& white : whites) {
+        white.Rows = Bitboard::MaxRows;
+        for (int i = 0; i < white.Rows; ++i) {
+            white.Bits[i] = ~uint64_t(0);
+        }
+        for (int k = 0; k < 500; ++k) {
+            white.reset(rng() % 64, rng() % 64);
+        }
+        agree += whiteConnectedPortable(white) == whiteConnectedAvx2(white) ? 1 : 0;
+    }
+    volatile bool sink = false;
+    double portable = nsPerCall(calls, [&](int c) { sink = whiteConnectedPortable(whites[c % whites.size()]); });
+    double avx2 = nsPerCall(calls, [&](int c) { sink = whiteConnectedAvx2(whites[c % whites.size()]); });
+    (void)sink;
+    cout << "Random 64x64 grid" << endl;
+    cout << "  white connectivity: portable " << portable << " ns, ";
+    if (hasAvx2()) {
+        cout << "avx2 " << avx2 << " ns, ";
+    }
+    cout << "agree " << agree << "/" << whites.size() << endl;
+
+    // Four rooms of 32 x 32 cells: no run crosses two borders, so the whole grid is scanned.
+    Bitboard rowBorders, colBorders;
+    rowBorders.Rows = colBorders.Rows = Bitboard::MaxRows;
+    for (int i = 0; i < Bitboard::MaxRows; ++i) {
+        rowBorders.Bits[i] = uint64_t(1) << 32;
+    }
+    colBorders.Bits[32] = ~uint64_t(0);
+    agree = 0;
+    for (const auto& white : whites) {
+        agree += longRunRowPortable(white, rowBorders) == longRunRowAvx2(white, rowBorders) ? 1 : 0;
+    }
+    volatile int runs = 0;
+    double rowsPortable = nsPerCall(calls, [&](int c) { runs = longRunRowPortable(whites[c % whites.size()], rowBorders); });
+    double rowsAvx2 = nsPerCall(calls, [&](int c) { runs = longRunRowAvx2(whites[c % whites.size()], rowBorders); });
+    double cols = nsPerCall(calls, [&](int c) { runs = longRunCol(whites[c % whites.size()], colBorders); });
+    (void)runs;
+    cout << "  three-room runs: rows portable " << rowsPortable << " ns, ";
+    if (hasAvx2()) {
+        cout << "rows avx2 " << rowsAvx2 << " ns, ";
+    }
+    cout << "columns " << cols << " ns, agree " << agree << "/" << whites.size() << endl;
+}
+
+}
+
+int main() {
+    mt19937 rng(12345);
+    for (size_t b = 0; b < builtinPuzzleCount(); ++b) {
+        Board board{vector<Cell>(), vector<Sector>()};
+        loadPuzzle(builtinPuzzle(b), board);
+        vector<Board> states = randomStates(board, 64, rng);
+        cout << "Board " << b + 1 << " (" << board.Cells.size() << " cells)" << endl;
+        benchWhiteLines(states);
+        benchRuns(states);
+        benchKernels(states);
+        benchAllocations(board);
+    }
+    benchLargeWhite(rng);
+}
@@ -0,0 +1,294 @@
+#include "bitboard.h"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HEYAWAKE_X86 1
+#endif
+using namespace std;
+
+namespace {
+
+// fillUp spreads the seeds x towards higher bits along the runs of m (Kogge-Stone occluded fill).
+inline uint64_t fillUp(uint64_t x, uint64_t m) {
+    uint64_t pro = m;
+    x |= pro & (x << 1); pro &= pro << 1;
+    x |= pro & (x << 2); pro &= pro << 2;
+    x |= pro & (x << 4); pro &= pro << 4;
+    x |= pro & (x << 8); pro &= pro << 8;
+    x |= pro & (x << 16); pro &= pro << 16;
+    x |= pro & (x << 32);
+    return x;
+}
+
+inline uint64_t fillDown(uint64_t x, uint64_t m) {
+    uint64_t pro = m;
+    x |= pro & (x >> 1); pro &= pro >> 1;
+    x |= pro & (x >> 2); pro &= pro >> 2;
+    x |= pro & (x >> 4); pro &= pro >> 4;
+    x |= pro & (x >> 8); pro &= pro >> 8;
+    x |= pro & (x >> 16); pro &= pro >> 16;
+    x |= pro & (x >> 32);
+    return x;
+}
+
+// fillRow spreads the seeds x along the runs of m in both directions.
+inline uint64_t fillRow(uint64_t x, uint64_t m) {
+    return fillUp(x, m) | fillDown(x, m);
+}
+
+// seed puts the lowest white cell into reached and returns false if there is no white cell.
+bool seed(const Bitboard& white, uint64_t* reached) {
+    for (int i = 0; i < white.Rows; ++i) {
+        if (white.Bits[i] != 0) {
+            reached[i] = white.Bits[i] & (~white.Bits[i] + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+bool whiteConnectedPortable(const Bitboard& white) {
+    uint64_t reached[Bitboard::MaxRows] = {};
+    int rows = white.Rows;
+    if (!seed(white, reached)) {
+        return true;
+    }
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < rows; ++i) {
+            uint64_t from = reached[i] | (i > 0 ? reached[i - 1] : 0) | (i + 1 < rows ? reached[i + 1] : 0);
+            uint64_t next = fillRow(from & white.Bits[i], white.Bits[i]);
+            if (next != reached[i]) {
+                reached[i] = next;
+                changed = true;
+            }
+        }
+        for (int i = rows - 1; i >= 0; --i) {
+            uint64_t from = reached[i] | (i > 0 ? reached[i - 1] : 0) | (i + 1 < rows ? reached[i + 1] : 0);
+            uint64_t next = fillRow(from & white.Bits[i], white.Bits[i]);
+            if (next != reached[i]) {
+                reached[i] = next;
+                changed = true;
+            }
+        }
+    }
+    for (int i = 0; i < rows; ++i) {
+        if (reached[i] != white.Bits[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Portable run kernel: cross marks the borders inside white runs; filling up from the cell after
+// each crossing reaches a later crossing exactly when both lie in the same run.
+int longRunRowPortable(const Bitboard& white, const Bitboard& borders) {
+    for (int i = 0; i < white.Rows; ++i) {
+        uint64_t w = white.Bits[i];
+        uint64_t cross = borders.Bits[i] & w & (w << 1);
+        if ((cross & (cross - 1)) == 0) {
+            continue;
+        }
+        if (cross & fillUp(w & (cross << 1), w)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// longRunCol walks down the rows once; reach marks the columns whose current run already crossed a border.
+int longRunCol(const Bitboard& white, const Bitboard& borders) {
+    uint64_t reach = 0, hits = 0;
+    for (int i = 1; i < white.Rows; ++i) {
+        uint64_t w = white.Bits[i];
+        uint64_t cross = borders.Bits[i] & w & white.Bits[i - 1];
+        reach &= w;
+        hits |= reach & cross;
+        reach |= cross;
+    }
+    return hits != 0 ? __builtin_ctzll(hits) : -1;
+}
+
+#ifdef HEYAWAKE_X86
+
+namespace {
+
+__attribute__((target("avx2"), always_inline))
+inline __m256i fillUp4(__m256i x, __m256i m) {
+    __m256i pro = m;
+    x = _mm256_or_si256(x, _mm256_and_si256(pro, _mm256_slli_epi64(x, 1))); pro = _mm256_and_si256(pro, _mm256_slli_epi64(pro, 1));
+    x = _mm256_or_si256(x, _mm256_and_si256(pro, _mm256_slli_epi64(x, 2))); pro = _mm256_and_si256(pro, _mm256_slli_epi64(pro, 2));
+    x = _mm256_or_si256(x, _mm256_and_si256(pro, _mm256_slli_epi64(x, 4))); pro = _mm256_and_si256(pro, _mm256_slli_epi64(pro, 4));
+    x = _mm256_or_si256(x, _mm256_and_si256(pro, _mm256_slli_epi64(x, 8))); pro = _mm256_and_si256(pro, _mm256_slli_epi64(pro, 8));
+    x = _mm256_or_si256(x, _mm256_and_si256(pro, _mm256_slli_epi64(x, 16))); pro = _mm256_and_si256(pro, _mm256_slli_epi64(pro, 16));
+    x = _mm256_or_si256(x, _mm256_and_si256(pro, _mm256_slli_epi64(x, 32)));
+    return x;
+}
+
+__attribute__((target("avx2"), always_inline))
+inline __m256i fillDown4(__m256i x, __m256i m) {
+    __m256i pro = m;
+    x = _mm256_or_si256(x, _mm256_and_si256(pro, _mm256_srli_epi64(x, 1))); pro = _mm256_and_si256(pro, _mm256_srli_epi64(pro, 1));
+    x = _mm256_or_si256(x, _mm256_and_si256(pro, _mm256_srli_epi64(x, 2))); pro = _mm256_and_si256(pro, _mm256_srli_epi64(pro, 2));
+    x = _mm256_or_si256(x, _mm256_and_si256(pro, _mm256_srli_epi64(x, 4))); pro = _mm256_and_si256(pro, _mm256_srli_epi64(pro, 4));
+    x = _mm256_or_si256(x, _mm256_and_si256(pro, _mm256_srli_epi64(x, 8))); pro = _mm256_and_si256(pro, _mm256_srli_epi64(pro, 8));
+    x = _mm256_or_si256(x, _mm256_and_si256(pro, _mm256_srli_epi64(x, 16))); pro = _mm256_and_si256(pro, _mm256_srli_epi64(pro, 16));
+    x = _mm256_or_si256(x, _mm256_and_si256(pro, _mm256_srli_epi64(x, 32)));
+    return x;
+}
+
+__attribute__((target("avx2"), always_inline))
+inline __m256i fillRows4(__m256i x, __m256i m) {
+    return _mm256_or_si256(fillUp4(x, m), fillDown4(x, m));
+}
+
+// fillColumns spreads reached along the columns of mask, down (dir 1) or up (dir -1), with
+// log-step shifts over whole rows. Rows are visited so that row r - dir * k is still unchanged
+// when row r reads it.
+__attribute__((target("avx2")))
+void fillColumns(uint64_t* reached, const uint64_t* mask, uint64_t* pro, int vectors, int rows, int dir) {
+    for (int v = 0; v < vectors; ++v) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pro + v * 4), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + v * 4)));
+    }
+    for (int k = 1; k < rows; k *= 2) {
+        for (int n = 0; n < vectors; ++n) {
+            int v = dir > 0 ? vectors - 1 - n : n;
+            int from = v * 4 - dir * k;
+            __m256i g = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(reached + v * 4));
+            __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pro + v * 4));
+            __m256i gk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(reached + from));
+            __m256i pk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pro + from));
+            g = _mm256_or_si256(g, _mm256_and_si256(p, gk));
+            p = _mm256_and_si256(p, pk);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(reached + v * 4), g);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pro + v * 4), p);
+        }
+    }
+}
+
+// dilate runs one round of row fills and column fills and reports whether anything changed.
+__attribute__((target("avx2")))
+bool dilate(uint64_t* reached, const uint64_t* mask, uint64_t* pro, int rows) {
+    int vectors = (rows + 3) / 4;
+    __m256i diff = _mm256_setzero_si256();
+    for (int v = 0; v < vectors; ++v) {
+        __m256i g = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(reached + v * 4));
+        __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + v * 4));
+        __m256i next = fillRows4(g, m);
+        diff = _mm256_or_si256(diff, _mm256_xor_si256(next, g));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(reached + v * 4), next);
+    }
+    alignas(32) uint64_t before[Bitboard::MaxRows];
+    memcpy(before, reached, vectors * 4 * sizeof(uint64_t));
+    fillColumns(reached, mask, pro, vectors, rows, 1);
+    fillColumns(reached, mask, pro, vectors, rows, -1);
+    for (int v = 0; v < vectors; ++v) {
+        __m256i g = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(reached + v * 4));
+        __m256i old = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(before + v * 4));
+        diff = _mm256_or_si256(diff, _mm256_xor_si256(g, old));
+    }
+    return !_mm256_testz_si256(diff, diff);
+}
+
+}
+
+// AVX2 kernel: iterated dilation where both the row fills and the column fills are log-step
+// Kogge-Stone fills, four rows per instruction. The rows live in a buffer with zero padding on both
+// sides, so shifted rows are plain unaligned loads.
+__attribute__((target("avx2")))
+bool whiteConnectedAvx2(const Bitboard& white) {
+    if (!hasAvx2()) {
+        return whiteConnectedPortable(white);
+    }
+    const int pad = Bitboard::MaxRows / 2;
+    const int size = pad + Bitboard::MaxRows + pad + 4;
+    alignas(32) uint64_t mask[size] = {};
+    alignas(32) uint64_t reached[size] = {};
+    alignas(32) uint64_t pro[size] = {};
+    int rows = white.Rows;
+    memcpy(mask + pad, white.Bits.data(), rows * sizeof(uint64_t));
+    if (!seed(white, reached + pad)) {
+        return true;
+    }
+    while (dilate(reached + pad, mask + pad, pro + pad, rows)) {
+    }
+    for (int i = 0; i < rows; ++i) {
+        if (reached[pad + i] != white.Bits[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// AVX2 run kernel: the same masks as the portable one for four rows per instruction. Rows past
+// white.Rows are zero in both boards, so the last group needs no special case.
+__attribute__((target("avx2")))
+int longRunRowAvx2(const Bitboard& white, const Bitboard& borders) {
+    if (!hasAvx2()) {
+        return longRunRowPortable(white, borders);
+    }
+    for (int i = 0; i < white.Rows; i += 4) {
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(white.Bits.data() + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(borders.Bits.data() + i));
+        __m256i cross = _mm256_and_si256(b, _mm256_and_si256(w, _mm256_slli_epi64(w, 1)));
+        __m256i seeds = _mm256_and_si256(w, _mm256_slli_epi64(cross, 1));
+        __m256i hits = _mm256_and_si256(cross, fillUp4(seeds, w));
+        if (!_mm256_testz_si256(hits, hits)) {
+            int rows = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(hits, _mm256_setzero_si256())));
+            return i + __builtin_ctz(~rows & 0xF);
+        }
+    }
+    return -1;
+}
+
+bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+#else
+
+bool whiteConnectedAvx2(const Bitboard& white) {
+    return whiteConnectedPortable(white);
+}
+
+int longRunRowAvx2(const Bitboard& white, const Bitboard& borders) {
+    return longRunRowPortable(white, borders);
+}
+
+bool hasAvx2() {
+    return false;
+}
+
+#endif
+
+namespace {
+
+atomic<bool (*)(const Bitboard&)> whiteKernel{whiteConnectedPortable};
+atomic<int (*)(const Bitboard&, const Bitboard&)> runKernel{longRunRowPortable};
+
+}
+
+WhiteKernel setWhiteKernel(WhiteKernel kernel) {
+    if (kernel == WhiteKernel::Avx2 && hasAvx2()) {
+        whiteKernel.store(whiteConnectedAvx2);
+        runKernel.store(longRunRowAvx2);
+        return WhiteKernel::Avx2;
+    }
+    whiteKernel.store(whiteConnectedPortable);
+    runKernel.store(longRunRowPortable);
+    return WhiteKernel::Portable;
+}
+
+bool whiteConnected(const Bitboard& white) {
+    return whiteKernel.load(memory_order_relaxed)(white);
+}
+
+int longRunRow(const Bitboard& white, const Bitboard& borders) {
+    return runKernel.load(memory_order_relaxed)(white, borders);
+}
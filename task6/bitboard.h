@@ -0,0 +1,60 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+// Bitboard is a board-shaped bit set: bit j of Bits[i] is the cell in row i, column j.
+// Boards up to 64 x 64 fit; Rows is the number of rows in use.
+struct Bitboard {
+    static constexpr int MaxRows = 64;
+    static constexpr int MaxCols = 64;
+    int Rows = 0;
+    std::array<uint64_t, MaxRows> Bits{};
+
+    void set(int i, int j) {
+        Bits[i] |= uint64_t(1) << j;
+    }
+    void reset(int i, int j) {
+        Bits[i] &= ~(uint64_t(1) << j);
+    }
+    bool test(int i, int j) const {
+        return (Bits[i] >> j) & 1;
+    }
+    bool empty() const {
+        for (int i = 0; i < Rows; ++i) {
+            if (Bits[i] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+enum class WhiteKernel {
+    Portable,
+    Avx2,
+};
+
+// whiteConnected reports whether the set cells form one orthogonally connected region (an empty
+// set counts as connected), using the kernel chosen by setWhiteKernel.
+bool whiteConnected(const Bitboard& white);
+// setWhiteKernel picks the connectivity and run kernels at runtime. Avx2 is only taken if the CPU
+// supports it; the default is Portable, which is faster on the boards `make bench` measures.
+// The choice applies to boards larger than every Solver specialization (solver.h), which use
+// these dynamic kernels; main and the daemon set it with --kernel portable|avx2.
+WhiteKernel setWhiteKernel(WhiteKernel kernel);
+// Portable kernel: Gauss-Seidel sweeps of row fills on 64-bit words.
+bool whiteConnectedPortable(const Bitboard& white);
+// AVX2 kernel: four rows per step; falls back to the portable kernel on other CPUs.
+bool whiteConnectedAvx2(const Bitboard& white);
+bool hasAvx2();
+
+// longRunRow returns the first row where one run of white cells crosses two room borders, or -1.
+// Bit j of borders.Bits[i] marks a border between cells (i, j - 1) and (i, j). Cells missing
+// from white (black cells and holes) end a run.
+int longRunRow(const Bitboard& white, const Bitboard& borders);
+int longRunRowPortable(const Bitboard& white, const Bitboard& borders);
+int longRunRowAvx2(const Bitboard& white, const Bitboard& borders);
+// longRunCol is the same for columns and returns the first column, or -1. Bit j of
+// borders.Bits[i] marks a border between cells (i - 1, j) and (i, j). All 64 columns are
+// scanned at once, so it has no vector variant.
+int longRunCol(const Bitboard& white, const Bitboard& borders);
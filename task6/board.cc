@@ -3,6 +3,9 @@
 #include "board.h"
 #include "shape.h"
 #include "combination.h"
+#include "queue.h"
+#include "session.h"
+#include "trace.h"
 #include <vector>
 #include <map>
 #include <array>
@@ -12,6 +15,8 @@
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <chrono>
+#include <deque>
 using namespace std;
 
 // Copy assignment operator
@@ -22,68 +27,244 @@ Board& Board::operator=(const Board& other) {
     Cells = other.Cells;
     Sectors.resize(other.Sectors.size());
      for (size_t i = 0; i < other.Sectors.size(); ++i) {
-        Sectors[i].Cells = other.Sectors[i].Cells;
-        Sectors[i].Number = other.Sectors[i].Number;
+        Sectors[i] = other.Sectors[i];
     }
     Indexes = other.Indexes;
     WhiteIndex = other.WhiteIndex;
+    Hash = other.Hash;
+    DeadStates = other.DeadStates;
+    Progress = other.Progress;
+    FilledCount = other.FilledCount;
+    Present = other.Present;
+    Black = other.Black;
+    RowBorders = other.RowBorders;
+    ColBorders = other.ColBorders;
+    Kernels = other.Kernels;
     return *this;
 }
 
 // Executes the solving process and handles output.
-void Board::run() {
-    int workers = 0;
-    atomic<bool> solutionFound{false};
-    mutex resultMutex;
-    condition_variable resultCV;
-    vector<thread> workerThreads;
-    mutex workerMutex;
+void Board::run(const SolveOptions& options) {
+    SolverContext context(options);
+    context.run(*this);
+}
+
+// solve runs the selected search engine until a solution is found, the search space is
+// exhausted, or options.Deadline / options.NodeBudget is reached. It returns only after every
+// worker has stopped. Use a SolverContext directly to solve many boards.
+SolveResult Board::solve(const SolveOptions& options) {
+    SolverContext context(options);
+    return context.solve(*this);
+}
+
+// solveLeaves runs the Combs generator and a pool of fill workers fed through a bounded queue.
+SolveResult Board::solveLeaves(const SolveOptions& options, SolveSession& session) {
+    // CombRecord is one generated combination as it travels from the generator to a worker.
+    struct CombRecord {
+        CellMask Cells;
+    };
+    BoundedQueue<CombRecord> queue(options.QueueCapacity);
+    size_t batchSize = max<size_t>(1, options.BatchSize);
+    int threads = session.Result.Stats.Threads;
+    atomic<bool>& cancel = session.Cancel;
+
+    int combinations = 0;
+    double depthSum = 0;
+    size_t maxDepth = 0;
+    atomic<bool> generatorDone{false};
 
+    // The generator blocks here while the queue is full, so it never runs far ahead of the workers.
     auto resultHandler = [&](const vector<Cell>& comb) {
-        if (solutionFound.load()) {
-            return;
+        CombRecord record;
+        ++combinations;
+        for (const auto& cell : comb) {
+            record.Cells.set(cellIndex(cell.i, cell.j));
         }
-        workers++;
-        Board board_copy = copy();
-        thread worker([this, board_copy, comb, &solutionFound, &resultMutex, &resultCV, workers ]() mutable {
-            vector<Cell> CombVec = {comb};
-			try {
-                bool validSolution = board_copy.fill(solutionFound, CombVec, true);
-                if (solutionFound.load()) {
+        if (!queue.tryPush(record)) {
+            TRACE_SPAN("queue full");
+            while (!queue.tryPush(record)) {
+                if (cancel.load()) {
                     return;
                 }
-                if (validSolution) {
-                    if (board_copy.valid()) {
-                        lock_guard<mutex> lock(resultMutex);
-                        if (!solutionFound.load()) {
-							cout << "Result:";
-                            cout << board_copy.display();
-							cout << "Solution found by worker: " << workers << endl;
-                            solutionFound.store(true); 
-                            resultCV.notify_all();
-                        }
+                this_thread::yield();
+            }
+        }
+        size_t depth = queue.size();
+        depthSum += depth;
+        maxDepth = max(maxDepth, depth);
+    };
+    auto doneHandler = [&]() {
+        generatorDone.store(true);
+    };
+
+    // Once the generator is done, workers without a batch count as idle and the fills still
+    // running hand them subtrees. busy counts the workers holding work, so none stops while
+    // another may still split.
+    mutex subtreeMutex;
+    deque<SearchTask> subtrees;
+    atomic<int> idleWorkers{0};
+    atomic<int> queuedSubtrees{0};
+    atomic<int> busy{0};
+    atomic<int> splits{0};
+    SplitHook fillSplits{&idleWorkers, &queuedSubtrees, [&](SearchTask&& task) {
+        lock_guard<mutex> lock(subtreeMutex);
+        subtrees.push_back(std::move(task));
+        queuedSubtrees.fetch_add(1);
+        splits.fetch_add(1);
+    }};
+    auto takeSubtree = [&](SearchTask& task) {
+        lock_guard<mutex> lock(subtreeMutex);
+        if (subtrees.empty()) {
+            return false;
+        }
+        task = std::move(subtrees.front());
+        subtrees.pop_front();
+        queuedSubtrees.fetch_sub(1);
+        return true;
+    };
+    // BatchTally counts the batches of one worker; each worker writes only its own.
+    struct BatchTally {
+        int Batches = 0;
+        size_t Items = 0;
+        size_t Largest = 0;
+    };
+    vector<BatchTally> tallies(threads);
+    double target = chrono::duration<double>(options.BatchTarget).count();
+
+    // Each worker sizes its next batch from the mean time per combination so far, so cheap
+    // rejections are taken many at a time and long fills one by one. All of a worker's
+    // combinations run on the same board.
+    auto workerLoop = [&](int worker) {
+        Board board = copy();
+        session.attach(board);
+        board.Scratch = session.Context.arena(worker);
+        pmr::vector<CombRecord> batch(batchSize, board.Scratch);
+        board.Splits = &fillSplits;
+        BatchTally& tally = tallies[worker];
+        double perItem = 0;
+        size_t want = 1;
+        bool idle = false;
+        auto setIdle = [&](bool now) {
+            if (now != idle) {
+                idle = now;
+                idleWorkers.fetch_add(now ? 1 : -1);
+            }
+        };
+        SearchTask subtree;
+        TraceWait queueWait("queue wait");
+        bool holding = false;
+        auto hold = [&](bool now) {
+            holding = now;
+            busy.fetch_add(now ? 1 : -1);
+        };
+        try {
+            while (!cancel.load()) {
+                bool drained = generatorDone.load();
+                hold(true);
+                if (drained && takeSubtree(subtree)) {
+                    queueWait.end();
+                    setIdle(false);
+                    board = subtree.State;
+                    if (board.resume(cancel, subtree.Candidates, subtree.CheckSectors) && board.valid()) {
+                        session.publish(board, worker);
                     }
+                    hold(false);
+                    continue;
                 }
-			} catch (const exception& e) {
-				cerr << "Exception in fill worker thread: " << e.what() << endl;
-			} catch (...) {
-				cerr << "Unknown exception in fill worker thread." << endl;
-			}
-        });
-        worker.detach();
+                size_t n = queue.popBatch(batch.data(), want);
+                if (n == 0) {
+                    queueWait.begin();
+                    hold(false);
+                    if (drained && busy.load() == 0 && queuedSubtrees.load() == 0) {
+                        break;
+                    }
+                    setIdle(drained);
+                    this_thread::yield();
+                    continue;
+                }
+                queueWait.end();
+                setIdle(false);
+                auto started = chrono::steady_clock::now();
+                for (size_t k = 0; k < n && !cancel.load(); ++k) {
+                    bool validSolution = board.fill(cancel, batch[k].Cells, true);
+                    if (validSolution && board.valid()) {
+                        session.publish(board, worker);
+                    }
+                }
+                double took = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+                perItem = tally.Items == 0 ? took / n : (perItem * tally.Items + took) / (tally.Items + n);
+                tally.Batches++;
+                tally.Items += n;
+                tally.Largest = max(tally.Largest, n);
+                want = perItem > 0 ? static_cast<size_t>(target / perItem) : batchSize;
+                want = min(max<size_t>(want, 1), batchSize);
+                hold(false);
+            }
+        } catch (const exception& e) {
+            cerr << "Exception in fill worker thread: " << e.what() << endl;
+            session.fail();
+        } catch (...) {
+            cerr << "Unknown exception in fill worker thread." << endl;
+            session.fail();
+        }
+        // A worker that has left no longer takes subtrees, so it must not count as idle: the
+        // fills still running would keep handing work to themselves.
+        setIdle(false);
+        queueWait.end();
+        if (holding) {
+            hold(false);
+        }
+        session.workerDone();
     };
-    thread generator = Combs(solutionFound, Sectors, Cells, resultHandler);
-    {
-        unique_lock<mutex> lock(resultMutex);
-        resultCV.wait(lock, [&]{ return solutionFound.load(); });
+    WorkerPool& pool = session.Context.Pool;
+    for (int t = 0; t < threads; ++t) {
+        session.workerStarted();
+        pool.submit([&workerLoop, t]() { workerLoop(t); });
     }
-    if (generator.joinable()) {
-        generator.join();
+    GroupEstimate estimate;
+    pool.submit([&]() {
+        try {
+            generateCombs(cancel, Sectors, Cells, resultHandler, &estimate, &pool, threads);
+        } catch (const exception& e) {
+            cerr << "Exception in Combs generator thread: " << e.what() << endl;
+            session.fail();
+        } catch (...) {
+            cerr << "Unknown exception in Combs generator thread." << endl;
+            session.fail();
+        }
+        doneHandler();
+    });
+
+    bool timedOut = session.wait();
+    pool.wait();
+    session.Result.Stats.Combinations = combinations;
+    session.Result.Stats.Splits = splits.load();
+    session.Result.Stats.RawProduct = estimate.RawProduct;
+    session.Result.Stats.PrunedProduct = estimate.PrunedProduct;
+    session.Result.Stats.MaxQueueDepth = maxDepth;
+    session.Result.Stats.MeanQueueDepth = combinations > 0 ? depthSum / combinations : 0;
+    size_t batched = 0;
+    for (const auto& tally : tallies) {
+        session.Result.Stats.Batches += tally.Batches;
+        session.Result.Stats.MaxBatch = max(session.Result.Stats.MaxBatch, tally.Largest);
+        batched += tally.Items;
     }
-	cout << "Total combinations processed: " << workers << endl;
+    int batches = session.Result.Stats.Batches;
+    session.Result.Stats.MeanBatch = batches > 0 ? static_cast<double>(batched) / batches : 0;
+    return session.finish(timedOut);
 }
 
 bool Board::isCorrect() {
+    if (Cells.size() > static_cast<size_t>(CellMask::MaxCells)) {
+        cerr << "invalid, board has more than " << CellMask::MaxCells << " cells" << endl;
+        return false;
+    }
+    for (const auto& cell : Cells) {
+        if (cell.i < 0 || cell.i >= Bitboard::MaxRows || cell.j < 0 || cell.j >= Bitboard::MaxCols) {
+            cerr << "invalid, cell " << cell.Coords() << " is outside the " << Bitboard::MaxRows << "x" << Bitboard::MaxCols << " grid" << endl;
+            return false;
+        }
+    }
     unordered_map<string, size_t> board_cell_index;
     for (size_t i = 0; i < Cells.size(); i++) {
         board_cell_index[Cells[i].Coords()] = i;
@@ -92,16 +273,17 @@ bool Board::isCorrect() {
     vector<vector<bool>> sector_cell_check(Sectors.size());
 
     for (size_t i = 0; i < Sectors.size(); ++i) {
-        sector_cell_check[i].resize(Sectors[i].Cells.size(), false);
-        for (size_t j = 0; j < Sectors[i].Cells.size(); j++) {
-            string coord = Sectors[i].Cells[j].Coords();
+        vector<Cell> sectorCells = Sectors[i].cellList();
+        sector_cell_check[i].resize(sectorCells.size(), false);
+        for (size_t j = 0; j < sectorCells.size(); j++) {
+            string coord = sectorCells[j].Coords();
             if (!board_cell_index.count(coord)) {
-                cout << "invalid, unaccounted sector cell, Sector " << i << "Cell " << j << endl;
+                cerr << "invalid, unaccounted sector cell, Sector " << i << "Cell " << j << endl;
                 return false;
             }
             size_t boardIndex = board_cell_index[coord];
             if (cell_filled_check[boardIndex]) {
-                cout << "invalid, overlap or duplicate, Board Cell " << coord << " in multiple sectors" << endl;
+                cerr << "invalid, overlap or duplicate, Board Cell " << coord << " in multiple sectors" << endl;
                 return false;
             }
             cell_filled_check[boardIndex] = true;
@@ -110,14 +292,14 @@ bool Board::isCorrect() {
     }
     for (size_t i = 0; i < Cells.size(); ++i) {
         if (!cell_filled_check[i]) {
-            cout << "invalid, unaccounted board cell: " << Cells[i].Coords() <<endl;
+            cerr << "invalid, unaccounted board cell: " << Cells[i].Coords() <<endl;
             return false;
         }
     }
     for (size_t i =0; i < sector_cell_check.size(); ++i) {
         for (size_t j = 0; j < sector_cell_check[i].size(); ++j) {
             if (!sector_cell_check[i][j]) {
-                cout << "invalid, unaccounted sector cell: Sector " << i << " Cell " << Sectors[i].Cells[j].Coords() <<endl;
+                cerr << "invalid, unaccounted sector cell: Sector " << i << " Cell " << Sectors[i].cellList()[j].Coords() <<endl;
                 return false;
             }
         }
@@ -143,26 +325,58 @@ string Board::display() const {
     return ss.str();
 }
 
+// setNumbers prepares a board for solving: number display, cell indexes and rectangular rooms.
 void Board::setNumbers() {
     for (size_t i = 0; i < Sectors.size(); ++i) {
+        Sectors[i].compact();
         if (Sectors[i].Number == nullptr) {
             continue;
         }
-        if (Sectors[i].Cells.empty()) {
+        if (Sectors[i].size() == 0) {
             continue;
         }
+        Cell first = Sectors[i].firstCell();
         for (size_t j = 0; j < Cells.size(); ++j) {
-            if (Cells[j].Equal(Sectors[i].Cells[0])) {
+            if (Cells[j].Equal(first)) {
                 Cells[j].NumberDisplay = Sectors[i].Number;
                 break; 
             }
         }
     }
     Indexes.clear();
+    Present = Bitboard();
     for (size_t i = 0; i < Cells.size(); ++i) {
         Indexes[{Cells[i].i, Cells[i].j}] = static_cast<int>(i);
+        if (Cells[i].i >= 0 && Cells[i].i < Bitboard::MaxRows && Cells[i].j >= 0 && Cells[i].j < Bitboard::MaxCols) {
+            Present.set(Cells[i].i, Cells[i].j);
+            Present.Rows = max(Present.Rows, Cells[i].i + 1);
+        }
+    }
+    Black = Bitboard();
+    Black.Rows = Present.Rows;
+    RowBorders = Bitboard();
+    ColBorders = Bitboard();
+    RowBorders.Rows = ColBorders.Rows = Present.Rows;
+    for (const auto& cell : Cells) {
+        if (!Present.test(cell.i, cell.j)) {
+            continue;
+        }
+        int sectionIdx = getSectionIndx(cell.i, cell.j);
+        if (cell.j > 0 && Present.test(cell.i, cell.j - 1)) {
+            int preSectionIdx = getSectionIndx(cell.i, cell.j - 1);
+            if (preSectionIdx > -1 && sectionIdx != preSectionIdx) {
+                RowBorders.set(cell.i, cell.j);
+            }
+        }
+        if (cell.i > 0 && Present.test(cell.i - 1, cell.j)) {
+            int preSectionIdx = getSectionIndx(cell.i - 1, cell.j);
+            if (preSectionIdx > -1 && sectionIdx != preSectionIdx) {
+                ColBorders.set(cell.i, cell.j);
+            }
+        }
     }
     Shape shape = shape.getShape(Cells);
+    Kernels = &boardKernels(Present.Rows, shape.MaxJ + 1);
         int num_rows = (shape.MaxI >= shape.MinI) ? (shape.MaxI + 1) : 0;
         WhiteIndex.assign(num_rows, vector<int>()); 
         if (num_rows > 0) {
@@ -175,6 +389,10 @@ void Board::setNumbers() {
         }
 }
 
+pmr::memory_resource* Board::scratch() const {
+    return Scratch != nullptr ? static_cast<pmr::memory_resource*>(Scratch) : pmr::get_default_resource();
+}
+
 Board Board::copy() const {
     return Board(*this);
 }
@@ -187,29 +405,174 @@ bool Board::add(int cell_index) {
 		return false;
 	}
 	Cells[cell_index].filled = true;
+	Hash ^= zobristKey(cell_index);
+	FilledCount++;
+	Black.set(Cells[cell_index].i, Cells[cell_index].j);
 	return true;
 }
 
+void Board::undo(int cell_index) {
+    if (cell_index < 0 || static_cast<size_t>(cell_index) >= Cells.size()) {
+		return;
+	}
+	if (!Cells[cell_index].filled) {
+		return;
+	}
+	Cells[cell_index].filled = false;
+	Hash ^= zobristKey(cell_index);
+	FilledCount--;
+	Black.reset(Cells[cell_index].i, Cells[cell_index].j);
+}
+
+// addOption adds the cells of one room option, or leaves the board unchanged and returns false.
+bool Board::addOption(const vector<Cell>& option, vector<int>& applied) {
+    for (const auto& cell : option) {
+        int idx = cellIndex(cell.i, cell.j);
+        if (!add(idx)) {
+            undoOption(applied);
+            return false;
+        }
+        applied.push_back(idx);
+    }
+    return true;
+}
+
+void Board::undoOption(vector<int>& applied) {
+    for (int idx : applied) {
+        undo(idx);
+    }
+    applied.clear();
+}
+
+// searchRooms chooses an option for each of groups[level..], in the order given by order or in
+// group order when it is nullptr, and fills the board below every full choice. It returns true
+// with the solution on the board.
+bool Board::searchRooms(
+    atomic<bool>& cancelFlag,
+    const vector<vector<vector<Cell>>>& groups,
+    const vector<vector<OptionMask>>& masks,
+    const vector<vector<size_t>>* order,
+    size_t level,
+    const CellMask& blocked
+) {
+    if (level == groups.size()) {
+        return search(cancelFlag, true) && valid();
+    }
+    vector<int> applied;
+    size_t options = groups[level].size();
+    for (size_t n = 0; n < options; ++n) {
+        if (cancelFlag.load()) {
+            return false;
+        }
+        size_t k = order != nullptr ? (*order)[level][n] : n;
+        const OptionMask& mask = masks[level][k];
+        if (mask.Cells.intersects(blocked) || !addOption(groups[level][k], applied)) {
+            continue;
+        }
+        if (!countNode(cancelFlag)) {
+            return false;
+        }
+        CellMask next = blocked;
+        next |= mask.Blocked;
+        if (searchRooms(cancelFlag, groups, masks, order, level + 1, next)) {
+            return true;
+        }
+        undoOption(applied);
+    }
+    return false;
+}
+
+// stateKey separates the sector phase from the white-lines phase of the same black cells.
+uint64_t Board::stateKey(bool checkSectors) const {
+    return checkSectors ? Hash ^ 0xA5A5A5A5A5A5A5A5ULL : Hash;
+}
+
+// countNode accounts one search node in Progress and remembers the deepest state seen.
+// It cancels the search and returns false once the node budget or NodeLimit is spent.
+bool Board::countNode(atomic<bool>& cancelFlag) {
+    if (++Steps > NodeLimit && NodeLimit > 0) {
+        cancelFlag.store(true);
+        return false;
+    }
+    if (Progress == nullptr) {
+        return true;
+    }
+    uint64_t nodes = Progress->Nodes.fetch_add(1, memory_order_relaxed) + 1;
+    if (Progress->NodeBudget > 0 && nodes > Progress->NodeBudget) {
+        Progress->BudgetExceeded.store(true);
+        cancelFlag.store(true);
+        TRACE_INSTANT("budget");
+        return false;
+    }
+    if (FilledCount > Progress->BestDepth.load(memory_order_relaxed)) {
+        lock_guard<mutex> lock(Progress->BestMutex);
+        if (FilledCount > Progress->BestDepth.load(memory_order_relaxed)) {
+            Progress->BestDepth.store(FilledCount, memory_order_relaxed);
+            Progress->BestFilled = filledIndexes();
+        }
+    }
+    return true;
+}
+
+CellMask Board::filledMask() const {
+    CellMask res;
+    for (size_t i = 0; i < Cells.size(); ++i) {
+        if (Cells[i].filled) {
+            res.set(static_cast<int>(i));
+        }
+    }
+    return res;
+}
+
+vector<int> Board::filledIndexes() const {
+    vector<int> res;
+    res.reserve(FilledCount);
+    for (size_t i = 0; i < Cells.size(); ++i) {
+        if (Cells[i].filled) {
+            res.push_back(static_cast<int>(i));
+        }
+    }
+    return res;
+}
+
+// setFilled replaces the filled cells without checking the rules, used to show results.
+void Board::setFilled(const vector<int>& cellIndexes) {
+    cleanFilled();
+    for (int idx : cellIndexes) {
+        if (idx < 0 || static_cast<size_t>(idx) >= Cells.size() || Cells[idx].filled) {
+            continue;
+        }
+        Cells[idx].filled = true;
+        Hash ^= zobristKey(idx);
+        FilledCount++;
+        Black.set(Cells[idx].i, Cells[idx].j);
+    }
+}
+
 bool Board::canAdd(const Cell& cell) { 
 	for (size_t i = 0; i < Sectors.size(); ++i) {
 		if (!canAddToSector(Sectors[i], cell)) {
 			return false;
 		}
 	}
-	if (nextToFilled(cell)) {
-		return false;
-	}
-	Cell* c_ptr = findCell(cell.i, cell.j);
-	if (c_ptr != nullptr && !c_ptr->filled) {
-		c_ptr->filled = true; 
-		bool ok = checkWhiteLines();
-		c_ptr->filled = false;
-		return ok;
-	}
-	return true;
+	return Kernels->CanBlack(Present, Black, cell.i, cell.j);
+}
+
+// checkWhiteLines checks that the white cells are connected, by flood fill on bitboards.
+bool Board::checkWhiteLines() const {
+    return Kernels->Connected(whiteCells());
+}
+
+Bitboard Board::whiteCells() const {
+    Bitboard white = Present;
+    for (int i = 0; i < white.Rows; ++i) {
+        white.Bits[i] &= ~Black.Bits[i];
+    }
+    return white;
 }
 
-bool Board::checkWhiteLines() {
+// checkWhiteLinesBfs is the previous level-by-level BFS over Cells, kept for benchmarks.
+bool Board::checkWhiteLinesBfs() {
 	vector<Cell> white_cells;
         white_cells.reserve(Cells.size());
         int indx = -1;
@@ -322,11 +685,12 @@ vector<vector<Cell>> Board::getRows(int rowIndx) const {
 }
 
 int Board::getSectionIndx(int row, int col) const {
+	Cell cell;
+	cell.i = row;
+	cell.j = col;
 	for (size_t i = 0; i < Sectors.size(); ++i) {
-		for (const auto& cell : Sectors[i].Cells) {
-			if (cell.i == row && cell.j == col) {
-				return static_cast<int>(i);
-			}
+		if (Sectors[i].Includes(cell)) {
+			return static_cast<int>(i);
 		}
 	}
 	return -1; 
@@ -345,8 +709,19 @@ vector<Cell> Board::getCol(int colIndx) const {
 	return col;
 }
 
-// checkHorizontalWhite checks for 2x2 white squares crossing sector boundaries horizontally
+// checkHorizontalWhite returns the first row where a white run spans more than two rooms, or -1.
 int Board::checkHorizontalWhite() const {
+    return Kernels->LongRunRow(whiteCells(), RowBorders);
+}
+
+// checkVerticalWhite returns the first column where a white run spans more than two rooms, or -1.
+int Board::checkVerticalWhite() const {
+    return Kernels->LongRunCol(whiteCells(), ColBorders);
+}
+
+// checkHorizontalWhiteWalk is the previous cell-by-cell walk, kept for benchmarks. It only looks
+// at the last row with white cells and does not end runs at holes.
+int Board::checkHorizontalWhiteWalk() const {
     vector<Cell> whiteCells = white();
     Shape shape = shape.getShape(whiteCells);
 
@@ -386,8 +761,8 @@ int Board::checkHorizontalWhite() const {
     return -1;
 }
 
-// checkVerticalWhite checks for 2x2 white squares crossing sector boundaries vertically 
-int Board::checkVerticalWhite() const {
+// checkVerticalWhiteWalk is the previous column walk, kept for benchmarks. It does not end runs at holes.
+int Board::checkVerticalWhiteWalk() const {
 	vector<Cell> whiteCells = white();
 	Shape shape = shape.getShape(whiteCells);
 
@@ -419,30 +794,27 @@ int Board::checkVerticalWhite() const {
 	return -1;
 }
 
-vector<Cell> Board::getPossibleSectors() {
-	vector<Cell> res;
+void Board::getPossibleSectors(pmr::vector<Cell>& res) {
+	res.clear();
 	for (size_t i = 0; i < Sectors.size(); ++i) {
 		if (fullSector(Sectors[i])) {
 			continue;
 		}
-		for (size_t j = 0; j < Sectors[i].Cells.size(); ++j) {
-            const Cell& sectorCell = Sectors[i].Cells[j];
+		Sectors[i].forEachCell([&](const Cell& sectorCell) {
             if (!canAddToSector(Sectors[i], sectorCell)) {
-                continue;
+                return;
             }
             Cell* c = findCell(sectorCell.i, sectorCell.j);
             if (c != nullptr && !c->filled) {
                 res.push_back(*c);
             }
-        }
-        return res;
+        });
+        return;
     }
-    return res;
 }
 
-vector<Cell> Board::getPossibleCells(int row, int col) {
-    vector<Cell> cells;
-    cells.reserve(Cells.size());
+void Board::getPossibleCells(int row, int col, pmr::vector<Cell>& cells) {
+    cells.clear();
     for (size_t i = 0; i < Cells.size(); ++i) {
         if (Cells[i].filled) {
             continue;
@@ -455,7 +827,6 @@ vector<Cell> Board::getPossibleCells(int row, int col) {
         }
         cells.push_back(Cells[i]);
     }
-    return cells;
 }
 
 // fill function is recursive backtracking solver
@@ -474,44 +845,202 @@ bool Board::fill(atomic<bool>& cancelFlag, const vector<Cell>& filledCells, bool
             return false;
         }
     }
-    vector<Cell> posibles = getPossibleSectors();
-    if (posibles.empty()) {
-        if (checkSectors) {
-            checkSectors = false;
-            if (!fullSectors()) {
-                return false;
+    return search(cancelFlag, checkSectors);
+}
+
+// fill overload for combinations stored as a set of cell indexes.
+bool Board::fill(atomic<bool>& cancelFlag, const CellMask& filledCells, bool checkSectors) {
+    if (cancelFlag.load()) return false;
+    cleanFilled();
+    bool ok = true;
+    filledCells.forEach([&](int idx) {
+        if (ok && !add(idx)) {
+            ok = false;
+        }
+    });
+    if (!ok) {
+        return false;
+    }
+    return search(cancelFlag, checkSectors);
+}
+
+// search continues fill from the current board state, adding and undoing one cell per level.
+// States that fail without cancellation are recorded in DeadStates and pruned on the next visit.
+bool Board::search(atomic<bool>& cancelFlag, bool checkSectors) {
+    return walk(cancelFlag, checkSectors, nullptr);
+}
+
+// resume searches a subtree handed off by another worker. The board must be the State of the
+// SearchTask; only its candidates are tried at the node.
+bool Board::resume(atomic<bool>& cancelFlag, const vector<int>& candidates, bool checkSectors) {
+    return walk(cancelFlag, checkSectors, &candidates);
+}
+
+// SplitInterval is the number of steps a walk takes before it offers work, and between offers,
+// so that short fills are never copied to another worker.
+constexpr int SplitInterval = 256;
+
+// walk is the search loop. Each open node is a frame on an explicit stack, so a worker can give
+// away the untried candidates of its shallowest node when Splits asks for work. A node whose
+// candidates were given away, and every node above it, is not recorded as dead: part of its
+// subtree is searched elsewhere. With handed set, the root node is not expanded but tries those
+// candidates.
+bool Board::walk(atomic<bool>& cancelFlag, bool checkSectors, const vector<int>* handed) {
+    TRACE_SPAN("fill");
+    // Frame is one open node: Added is the cell of the child being searched, or -1.
+    struct Frame {
+        uint64_t Key = 0;
+        bool CheckSectors = false;
+        bool Shared = false;
+        size_t Next = 0;
+        int Added = -1;
+        pmr::vector<int> Candidates;
+
+        explicit Frame(pmr::memory_resource* resource) : Candidates(resource) {}
+    };
+    enum class Node { Open, Solved, Failed };
+
+    // The frames and their candidate lists live in Scratch until walk returns.
+    ScratchScope scope(Scratch);
+    pmr::vector<Cell> posibles(scratch());
+    pmr::vector<Frame> frames(scratch());
+    size_t depth = 0;
+    int sinceSplit = 0;
+
+    auto dead = [&](uint64_t key) {
+        if (DeadStates != nullptr && !cancelFlag.load()) {
+            DeadStates->insert(key);
+        }
+        return Node::Failed;
+    };
+    // expand opens the node of the current board on frame, as one call of the recursive search did.
+    auto expand = [&](Frame& frame, bool sectors) {
+        frame.Next = 0;
+        frame.Added = -1;
+        frame.Shared = false;
+        frame.Candidates.clear();
+        if (cancelFlag.load()) return Node::Failed;
+        if (!countNode(cancelFlag)) return Node::Failed;
+        frame.Key = stateKey(sectors);
+        if (DeadStates != nullptr && DeadStates->contains(frame.Key)) {
+            Hits++;
+            if (Progress != nullptr) {
+                Progress->TableHits.fetch_add(1, memory_order_relaxed);
             }
+            return Node::Failed;
         }
-        int problRow = checkHorizontalWhite();
-        if (problRow > -1) {
-            posibles = getPossibleCells(problRow, -1);
-        } else {
-            int problCol = checkVerticalWhite();
-            if (problCol > -1) {
-                posibles = getPossibleCells(-1, problCol);
+        getPossibleSectors(posibles);
+        if (posibles.empty()) {
+            // The whole-board checks run only once every room has its black cells.
+            TRACE_SPAN("checks");
+            if (sectors) {
+                sectors = false;
+                if (!fullSectors()) {
+                    return dead(frame.Key);
+                }
+            }
+            int problRow = checkHorizontalWhite();
+            if (problRow > -1) {
+                getPossibleCells(problRow, -1, posibles);
             } else {
-                return true;
+                int problCol = checkVerticalWhite();
+                if (problCol > -1) {
+                    getPossibleCells(-1, problCol, posibles);
+                } else {
+                    return Node::Solved;
+                }
+            }
+            if (posibles.empty() && (problRow > -1 || checkVerticalWhite() > -1)) {
+                return dead(frame.Key);
             }
         }
-        if (posibles.empty() && (problRow > -1 || checkVerticalWhite() > -1)) {
-            return false;
+        frame.CheckSectors = sectors;
+        for (const auto& cell : posibles) {
+            frame.Candidates.push_back(cellIndex(cell.i, cell.j));
         }
-    }
-    vector<Cell> children = filledCells;
-    children.emplace_back();
+        if (Shuffle != 0) {
+            for (size_t k = frame.Candidates.size(); k > 1; --k) {
+                Shuffle = Shuffle * 6364136223846793005ULL + 1442695040888963407ULL;
+                swap(frame.Candidates[k - 1], frame.Candidates[(Shuffle >> 33) % k]);
+            }
+        }
+        return Node::Open;
+    };
+    auto push = [&]() -> Frame& {
+        if (depth == frames.size()) {
+            frames.emplace_back(scratch());
+        }
+        return frames[depth++];
+    };
+    // split gives the untried candidates of the shallowest open node to Splits, with the board
+    // as it was at that node.
+    auto split = [&]() {
+        for (size_t f = 0; f < depth; ++f) {
+            Frame& frame = frames[f];
+            if (frame.Next >= frame.Candidates.size()) {
+                continue;
+            }
+            SearchTask task{copy()};
+            for (size_t g = depth; g-- > f;) {
+                task.State.undo(frames[g].Added);
+            }
+            task.Candidates.assign(frame.Candidates.begin() + frame.Next, frame.Candidates.end());
+            task.CheckSectors = frame.CheckSectors;
+            frame.Candidates.resize(frame.Next);
+            for (size_t g = 0; g <= f; ++g) {
+                frames[g].Shared = true;
+            }
+            Splits->Give(std::move(task));
+            return;
+        }
+    };
 
-    bool solutionFoundInBranch = false;
-    for (size_t i = 0; i < posibles.size(); ++i) {
+    Frame& root = push();
+    if (handed != nullptr) {
+        root.Shared = true;
+        root.CheckSectors = checkSectors;
+        root.Candidates.assign(handed->begin(), handed->end());
+    } else {
+        Node node = expand(root, checkSectors);
+        if (node != Node::Open) {
+            return node == Node::Solved;
+        }
+    }
+    while (depth > 0) {
         if (cancelFlag.load()) {
             return false;
         }
-        children.back() = posibles[i];
-        if (fill(cancelFlag, children, checkSectors)) {
-            solutionFoundInBranch = true;
-            break;
+        Frame& frame = frames[depth - 1];
+        if (frame.Added >= 0) {
+            undo(frame.Added);
+            frame.Added = -1;
+        }
+        if (Splits != nullptr && ++sinceSplit >= SplitInterval && Splits->wanted()) {
+            sinceSplit = 0;
+            split();
+        }
+        if (frame.Next >= frame.Candidates.size()) {
+            if (!frame.Shared) {
+                dead(frame.Key);
+            }
+            depth--;
+            continue;
+        }
+        int idx = frame.Candidates[frame.Next++];
+        if (!add(idx)) {
+            continue;
+        }
+        frame.Added = idx;
+        bool sectors = frame.CheckSectors;
+        Node node = expand(push(), sectors);
+        if (node == Node::Solved) {
+            return true;
+        }
+        if (node == Node::Failed) {
+            depth--;
         }
     }
-   return solutionFoundInBranch;
+    return false;
 }
 
 // Checks if the current board state is valid according to all rules.
@@ -535,6 +1064,10 @@ void Board::cleanFilled() {
     for (size_t i = 0; i < Cells.size(); ++i) {
         Cells[i].filled = false;
     }
+    Hash = 0;
+    FilledCount = 0;
+    Black = Bitboard();
+    Black.Rows = Present.Rows;
 }
 
 int Board::cellIndex(int i, int j) const {
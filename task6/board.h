@@ -1,38 +1,123 @@
 #pragma once
 #include "cell.h"
+#include "cellmask.h"
+#include "combination.h"
+#include "bitboard.h"
 #include "sector.h"
+#include "solver.h"
+#include "context.h"
+#include "arena.h"
+#include "options.h"
+#include "progress.h"
+#include "result.h"
+#include "zobrist.h"
 #include <vector>
+#include <memory_resource>
 #include <map>
 #include <array>
 #include <atomic>
 #include <thread>
 #include <functional>
 
+class SolveSession;
+struct SearchTask;
+
+// SplitHook lets a busy search hand part of its tree to idle workers. While Idle is positive and
+// no task is Queued, search gives away the untried candidates of its shallowest open node.
+struct SplitHook {
+    const std::atomic<int>* Idle = nullptr;
+    const std::atomic<int>* Queued = nullptr;
+    std::function<void(SearchTask&&)> Give;
+
+    bool wanted() const {
+        return Idle->load(std::memory_order_relaxed) > 0 && Queued->load(std::memory_order_relaxed) == 0;
+    }
+};
+
 class Board {
     public:
         std::vector<Cell> Cells;
         std::vector<Sector> Sectors;
         std::map<std::array<int, 2>, int> Indexes;
 		std::vector<std::vector<int>> WhiteIndex;
+        // Hash is the Zobrist hash of the filled cells, kept in sync by add/undo.
+        uint64_t Hash = 0;
+        // DeadStates is the shared table of states proven unsolvable, may be nullptr.
+        TranspositionTable* DeadStates = nullptr;
+        // Progress is the node accounting shared by the workers of one solve, may be nullptr.
+        SearchProgress* Progress = nullptr;
+        int FilledCount = 0;
+        // Present holds the board cells, Black the filled ones; both follow add/undo.
+        Bitboard Present;
+        Bitboard Black;
+        // RowBorders and ColBorders mark the room borders before each cell, see longRunRow.
+        Bitboard RowBorders;
+        Bitboard ColBorders;
+        // Kernels are the bitboard checks for the board size, picked in setNumbers.
+        const BoardKernels* Kernels = &boardKernels(Bitboard::MaxRows, Bitboard::MaxCols);
+        // Scratch holds the per-node temporaries of search, may be nullptr. It belongs to one
+        // thread, so copies of the board do not inherit it.
+        ScratchArena* Scratch = nullptr;
+        // Splits is where search hands off subtrees, may be nullptr. Like Scratch it is not copied.
+        SplitHook* Splits = nullptr;
+        // Shuffle seeds a random order of the candidates at every search node, 0 keeps the board
+        // order. Steps and Hits count the nodes and table hits of this board alone, and once
+        // NodeLimit (if not 0) is passed the search is cancelled. None of these is copied.
+        uint64_t Shuffle = 0;
+        uint64_t Steps = 0;
+        uint64_t Hits = 0;
+        uint64_t NodeLimit = 0;
 
+        // isCorrect checks that rooms and cells match; the reason for a failure goes to cerr, so
+        // stdout stays clean for callers such as the stream mode.
         bool isCorrect();
-        void run();
+        void run(const SolveOptions& options = SolveOptions());
+        SolveResult solve(const SolveOptions& options = SolveOptions());
+        SolveResult solveLeaves(const SolveOptions& options, SolveSession& session);
+        SolveResult solvePrefixTree(const SolveOptions& options, SolveSession& session);
+        SolveResult solvePortfolio(const SolveOptions& options, SolveSession& session);
+        SolveResult solveDeterministic(const SolveOptions& options, SolveSession& session);
         void setNumbers();
         Board copy() const;
+        std::pmr::memory_resource* scratch() const;
         bool fill(std::atomic<bool>& canselFlag, const std::vector<Cell>& filledCells, bool checkSectors);      
+        bool fill(std::atomic<bool>& canselFlag, const CellMask& filledCells, bool checkSectors);
+        bool search(std::atomic<bool>& canselFlag, bool checkSectors);
+        bool resume(std::atomic<bool>& canselFlag, const std::vector<int>& candidates, bool checkSectors);
         bool add(int i);
+        void undo(int i);
+        bool addOption(const std::vector<Cell>& option, std::vector<int>& applied);
+        void undoOption(std::vector<int>& applied);
+        bool searchRooms(
+            std::atomic<bool>& canselFlag,
+            const std::vector<std::vector<std::vector<Cell>>>& groups,
+            const std::vector<std::vector<OptionMask>>& masks,
+            const std::vector<std::vector<size_t>>* order,
+            size_t level,
+            const CellMask& blocked
+        );
+        uint64_t stateKey(bool checkSectors) const;
+        bool countNode(std::atomic<bool>& canselFlag);
+        std::vector<int> filledIndexes() const;
+        CellMask filledMask() const;
+        void setFilled(const std::vector<int>& cellIndexes);
         bool canAdd(const Cell& cell);
-        bool checkWhiteLines();
+        bool checkWhiteLines() const;
+        bool checkWhiteLinesBfs();
+        Bitboard whiteCells() const;
 		void checkNexts(std::vector<Cell>& white, const std::vector<Cell>& nexts, const std::vector<std::vector<int>>& m);
 		std::vector<Cell> getNexts(const std::vector<std::vector<int>>& m, std::vector<Cell> & white, const Cell& start);
 		bool fullSectors() const;
         int checkHorizontalWhite() const;
+        int checkHorizontalWhiteWalk() const;
         std::vector<std::vector<Cell>> getRows(int rowIndx) const;
         int getSectionIndx(int row, int col) const;
         int checkVerticalWhite() const;
+        int checkVerticalWhiteWalk() const;
 		std::vector<Cell> getCol(int colIndx) const;
-        std::vector<Cell> getPossibleSectors();
-        std::vector<Cell> getPossibleCells(int row, int col);
+        // getPossibleSectors and getPossibleCells replace the contents of res with candidate cells.
+        void getPossibleSectors(std::pmr::vector<Cell>& res);
+        void getPossibleCells(int row, int col, std::pmr::vector<Cell>& res);
         std::string display() const;
         bool valid();
         void cleanFilled();
@@ -44,6 +129,7 @@ class Board {
         bool canAddToSector(const Sector& sector, const Cell& cell) const;
         bool nextToFilled(const Cell& cell) const;
         std::vector<Cell> white() const;
+        bool walk(std::atomic<bool>& canselFlag, bool checkSectors, const std::vector<int>* handed);
         Board& operator=(const Board& other);
 
         // Copy constructor (need for board.copy())
@@ -51,15 +137,31 @@ class Board {
         Cells(other.Cells),
         Sectors(other.Sectors.size()),
         Indexes(other.Indexes),
-        WhiteIndex(other.WhiteIndex)
+        WhiteIndex(other.WhiteIndex),
+        Hash(other.Hash),
+        DeadStates(other.DeadStates),
+        Progress(other.Progress),
+        FilledCount(other.FilledCount),
+        Present(other.Present),
+        Black(other.Black),
+        RowBorders(other.RowBorders),
+        ColBorders(other.ColBorders),
+        Kernels(other.Kernels)
     {
-        // Deep copy Sectors (Cells vector and shared_ptr Number)
+        // Deep copy Sectors (rectangle, Cells vector and shared_ptr Number)
         for (size_t i = 0; i < other.Sectors.size(); ++i) {
-            Sectors[i].Cells = other.Sectors[i].Cells;
-            Sectors[i].Number = other.Sectors[i].Number;
+            Sectors[i] = other.Sectors[i];
         }
     }
     Board(std::vector<Cell> cells, std::vector<Sector> sectors, std::map<std::array<int, 2> ,int> indexes = {}, std::vector<std::vector<int>> whiteIndx = {})
     : Cells(std::move(cells)), Sectors(std::move(sectors)),
       Indexes(std::move(indexes)), WhiteIndex(std::move(whiteIndx)) {}
 };
+
+// SearchTask is a subtree handed off by search: the board at an open node, the candidate cells
+// not tried there yet and the phase of the node.
+struct SearchTask {
+    Board State{std::vector<Cell>(), std::vector<Sector>()};
+    std::vector<int> Candidates;
+    bool CheckSectors = false;
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+// CellMask is a fixed-size set of board cell indexes (positions in Board::Cells), large enough
+// for a full 64x64 board. Top is the number of leading words that may hold bits, so small
+// boards only touch the words they use.
+struct CellMask {
+    static constexpr int MaxCells = 64 * 64;
+    static constexpr int Words = MaxCells / 64;
+    std::array<uint64_t, Words> Bits{};
+    int Top = 0;
+
+    void set(int i) {
+        Bits[i >> 6] |= uint64_t(1) << (i & 63);
+        Top = std::max(Top, (i >> 6) + 1);
+    }
+    void reset(int i) {
+        Bits[i >> 6] &= ~(uint64_t(1) << (i & 63));
+    }
+    bool test(int i) const {
+        return (Bits[i >> 6] >> (i & 63)) & 1;
+    }
+    bool intersects(const CellMask& other) const {
+        uint64_t any = 0;
+        for (int w = 0, top = std::min(Top, other.Top); w < top; ++w) {
+            any |= Bits[w] & other.Bits[w];
+        }
+        return any != 0;
+    }
+    CellMask& operator|=(const CellMask& other) {
+        for (int w = 0; w < other.Top; ++w) {
+            Bits[w] |= other.Bits[w];
+        }
+        Top = std::max(Top, other.Top);
+        return *this;
+    }
+    int count() const {
+        int n = 0;
+        for (int w = 0; w < Top; ++w) {
+            n += __builtin_popcountll(Bits[w]);
+        }
+        return n;
+    }
+    // forEach calls f with every index in the set in increasing order.
+    template <typename F>
+    void forEach(F f) const {
+        for (int w = 0; w < Top; ++w) {
+            uint64_t word = Bits[w];
+            while (word != 0) {
+                f(w * 64 + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+    }
+};
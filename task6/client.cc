@@ -0,0 +1,49 @@
+#include "client.h"
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using namespace std;
+
+SolverClient::~SolverClient() {
+    close();
+}
+
+bool SolverClient::connect(const string& socketPath) {
+    close();
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    strcpy(addr.sun_path, socketPath.c_str());
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool SolverClient::send(const PuzzleRequest& request) {
+    return fd >= 0 && writeFrame(fd, encodeRequest(request));
+}
+
+bool SolverClient::receive(PuzzleReply& reply) {
+    string payload;
+    return fd >= 0 && readFrame(fd, payload) && decodeReply(payload, reply);
+}
+
+bool SolverClient::solve(const PuzzleRequest& request, PuzzleReply& reply) {
+    return send(request) && receive(reply) && reply.Id == request.Id;
+}
+
+void SolverClient::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
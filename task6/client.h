@@ -0,0 +1,23 @@
+#pragma once
+#include "protocol.h"
+#include <string>
+
+// SolverClient is one connection to the solver daemon. send and receive may be interleaved to
+// keep several requests in flight; solve is the one-at-a-time shortcut.
+class SolverClient {
+    public:
+        SolverClient() = default;
+        SolverClient(const SolverClient&) = delete;
+        SolverClient& operator=(const SolverClient&) = delete;
+        ~SolverClient();
+
+        bool connect(const std::string& socketPath);
+        bool send(const PuzzleRequest& request);
+        bool receive(PuzzleReply& reply);
+        // solve sends request and waits for its reply; no other request may be in flight.
+        bool solve(const PuzzleRequest& request, PuzzleReply& reply);
+        void close();
+
+    private:
+        int fd = -1;
+};
@@ -1,105 +1,264 @@
 #include "cell.h"
 #include "sector.h" 
-#include "validator.h"
 #include "combination.h"
+#include "pool.h"
+#include "trace.h"
 #include <thread>
 #include <atomic>
+#include <exception>
 #include <functional>
 #include <iostream>
 #include <vector>
+#include <map>
+#include <array>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 using namespace std;
 
-// Generates combinations in a separate thread, with cancellation support
-std::thread Combs(
+// roomGroups builds the placement lists of the numbered rooms, ordered along the room adjacency
+// graph so that neighboring rooms, which constrain each other, are chosen one after another. The
+// list is cut where the product of the group sizes passes the generator limit; later rooms are left
+// to fill. Returns false when cancelled or when a numbered room has no valid placement.
+//
+// With a pool, up to helpers jobs enumerate the rooms at once, largest rooms first. Each room is
+// written straight into its own slot, and the first room without placements stops the others.
+bool roomGroups(
     std::atomic<bool>& cancel,
     const std::vector<Sector>& sectors,
-    const std::vector<Cell> cells,
-    std::function<void(const std::vector<Cell>)> resultHandler
+    std::vector<std::vector<std::vector<Cell>>>& groups,
+    GroupEstimate* estimate,
+    WorkerPool* pool,
+    int helpers
 ) {
-    thread generator_thread([&cancel, sectors, resultHandler]() {
-        try {
-            vector<vector<vector<Cell>>> groups;
-            for (size_t i = 0; i < sectors.size(); ++i) {
-                 if (cancel.load()) return; 
-                if (sectors[i].Number != nullptr && *sectors[i].Number > 0) {
-                    groups.push_back(sectors[i].Combs());
-                }
+    TRACE_SPAN("rooms");
+    groups.clear();
+    vector<int> rooms;
+    for (size_t i = 0; i < sectors.size(); ++i) {
+        if (sectors[i].Number != nullptr && *sectors[i].Number > 0) {
+            rooms.push_back(static_cast<int>(i));
+        }
+    }
+    vector<vector<vector<Cell>>> byRoom(rooms.size());
+    vector<size_t> bySize(rooms.size());
+    for (size_t k = 0; k < bySize.size(); ++k) {
+        bySize[k] = k;
+    }
+    stable_sort(bySize.begin(), bySize.end(), [&](size_t a, size_t b) {
+        return sectors[rooms[a]].size() > sectors[rooms[b]].size();
+    });
+
+    // abort stops the running enumerations; failed tells an empty room from a cancel.
+    atomic<bool> abort{false};
+    atomic<bool> failed{false};
+    atomic<size_t> nextRoom{0};
+    auto enumerate = [&](const atomic<bool>* stop) {
+        for (size_t n = nextRoom.fetch_add(1); n < bySize.size(); n = nextRoom.fetch_add(1)) {
+            if (stop->load()) {
+                return;
             }
-            sort(groups.begin(), groups.end(), [](const vector<vector<Cell>>& a, const vector<vector<Cell>>& b) {
-                return a.size() < b.size();
-            });
-            long long m = 0;
-            size_t limit_idx = groups.size();
-            for (size_t i = 0; i < groups.size(); ++i) {
-                 if (cancel.load()) return;
-                if (groups[i].empty() && (sectors[i].Number && *sectors[i].Number > 0)) {            
-                     return; 
-                }
-                if (m == 0) {
-                    if (!groups[i].empty()) {
-                       m = groups[i].size();
-                    }
-                    continue;
-                }
-                if (groups[i].empty()) {
-                    continue; 
-                }
+            size_t k = bySize[n];
+            byRoom[k] = sectors[rooms[k]].Combs(stop);
+            if (byRoom[k].empty()) {
+                failed.store(true);
+                abort.store(true);
+                return;
+            }
+        }
+    };
 
-                long long current_size = groups[i].size();
-                if (current_size > 0 && m > 100'000'000LL / current_size) {
-                    limit_idx = i;
-                    break;
-                }
-                m *= current_size;
-                if (m > 100'000'000LL) {
-                    limit_idx = i;
-                    break;
+    int jobs = static_cast<int>(min<size_t>(helpers > 0 ? helpers : 1, rooms.size()));
+    if (pool == nullptr || jobs < 2) {
+        enumerate(&cancel);
+    } else {
+        // The caller does not join the pool: its own jobs may be the search workers waiting for
+        // these groups. It waits here and forwards the outer cancel instead.
+        mutex doneMutex;
+        condition_variable doneCV;
+        int running = jobs;
+        // An error in a job is passed on to the caller, so it is not taken for an empty room.
+        exception_ptr error;
+        for (int t = 0; t < jobs; ++t) {
+            pool->submit([&]() {
+                try {
+                    enumerate(&abort);
+                } catch (...) {
+                    abort.store(true);
+                    lock_guard<mutex> lock(doneMutex);
+                    error = current_exception();
                 }
+                lock_guard<mutex> lock(doneMutex);
+                running--;
+                doneCV.notify_all();
+            });
+        }
+        unique_lock<mutex> lock(doneMutex);
+        while (running > 0) {
+            doneCV.wait_for(lock, chrono::milliseconds(1));
+            if (cancel.load()) {
+                abort.store(true);
             }
-            if (limit_idx < groups.size()) {
-                groups.resize(limit_idx);
+        }
+        if (error) {
+            rethrow_exception(error);
+        }
+    }
+    if (cancel.load() || failed.load()) return false;
+    vector<size_t> sizes;
+    for (const auto& options : byRoom) {
+        sizes.push_back(options.size());
+    }
+    vector<vector<int>> adjacency = roomAdjacency(sectors);
+    vector<int> order = roomOrder(adjacency, rooms, sizes);
+
+    long long m = 1;
+    vector<int> chosen;
+    for (size_t i = 0; i < order.size(); ++i) {
+        size_t r = find(rooms.begin(), rooms.end(), order[i]) - rooms.begin();
+        long long current_size = byRoom[r].size();
+        if (i > 0 && m > GeneratorLimit / current_size) {
+            break;
+        }
+        m *= current_size;
+        chosen.push_back(static_cast<int>(r));
+    }
+    double raw = 1, pruned = 1;
+    for (size_t i = 0; i < chosen.size(); ++i) {
+        const vector<vector<Cell>>& options = byRoom[chosen[i]];
+        raw *= options.size();
+        pruned *= options.size();
+        for (size_t j = 0; j < i; ++j) {
+            const vector<int>& near = adjacency[rooms[chosen[i]]];
+            if (binary_search(near.begin(), near.end(), rooms[chosen[j]])) {
+                pruned *= compatibleRate(byRoom[chosen[j]], options);
             }
-            function<void(int, vector<Cell>)> backtrack;
-            backtrack = [&](int index, vector<Cell>path) {
-                if (cancel.load()) {
-                    return;
-                } 
+        }
+    }
+    if (estimate != nullptr) {
+        estimate->RawProduct = raw;
+        estimate->PrunedProduct = pruned;
+    }
+    for (int r : chosen) {
+        groups.push_back(std::move(byRoom[r]));
+    }
+    return true;
+}
 
-                if (index == static_cast<int>(groups.size())) {
-                    if (validComb(path)) {
-                      
-                        resultHandler(path);
-                        if (cancel.load()) {
-                            return;
-                        } 
-                    }
-                    return;
-                }
-                if (groups[index].empty()) {
-                     backtrack(index + 1, path);
-                     return;
-                }
-                for (const auto& option : groups[index]) {
-                    if (cancel.load()){
-                         return; 
+// optionMasks converts every room option to cell index masks. Two options are compatible exactly
+// when the Cells of one do not intersect the Blocked of the other.
+std::vector<std::vector<OptionMask>> optionMasks(
+    const std::vector<std::vector<std::vector<Cell>>>& groups,
+    const std::vector<Cell>& cells
+) {
+    map<array<int, 2>, int> indexes;
+    for (size_t i = 0; i < cells.size(); ++i) {
+        indexes[{cells[i].i, cells[i].j}] = static_cast<int>(i);
+    }
+    auto indexOf = [&](int i, int j) {
+        auto it = indexes.find({i, j});
+        return it != indexes.end() ? it->second : -1;
+    };
+    vector<vector<OptionMask>> masks(groups.size());
+    for (size_t g = 0; g < groups.size(); ++g) {
+        masks[g].resize(groups[g].size());
+        for (size_t k = 0; k < groups[g].size(); ++k) {
+            OptionMask& mask = masks[g][k];
+            for (const auto& cell : groups[g][k]) {
+                const array<array<int, 2>, 5> around = {{
+                    {cell.i, cell.j},
+                    {cell.i - 1, cell.j},
+                    {cell.i + 1, cell.j},
+                    {cell.i, cell.j - 1},
+                    {cell.i, cell.j + 1},
+                }};
+                for (size_t n = 0; n < around.size(); ++n) {
+                    int idx = indexOf(around[n][0], around[n][1]);
+                    if (idx < 0) {
+                        continue;
                     }
-                    vector<Cell> next_path = path;
-                    next_path.insert(next_path.end(), option.begin(), option.end());
-
-                    if (validComb(next_path)) {
-                        backtrack(index + 1, next_path);
-                        if (cancel.load()) {
-                            return;
-                        } 
+                    if (n == 0) {
+                        mask.Cells.set(idx);
                     }
+                    mask.Blocked.set(idx);
                 }
-            };
-            backtrack(0, vector<Cell>{});
+            }
+        }
+    }
+    return masks;
+}
+
+// generateCombs calls resultHandler with every combination of room placements that do not
+// touch each other, until the list is exhausted or cancel is set.
+void generateCombs(
+    std::atomic<bool>& cancel,
+    const std::vector<Sector>& sectors,
+    const std::vector<Cell>& cells,
+    const std::function<void(const std::vector<Cell>)>& resultHandler,
+    GroupEstimate* estimate,
+    WorkerPool* pool,
+    int helpers
+) {
+    vector<vector<vector<Cell>>> groups;
+    if (!roomGroups(cancel, sectors, groups, estimate, pool, helpers)) {
+        return;
+    }
+    vector<vector<OptionMask>> masks = optionMasks(groups, cells);
+    // path holds the cells of the options chosen so far; blocked holds them and their neighbors.
+    vector<Cell> path;
+    function<void(int, const CellMask&)> backtrack;
+    backtrack = [&](int index, const CellMask& blocked) {
+        if (cancel.load()) {
+            return;
+        } 
+
+        if (index == static_cast<int>(groups.size())) {
+            resultHandler(path);
+            return;
+        }
+        for (size_t k = 0; k < groups[index].size(); ++k) {
+            if (cancel.load()){
+                 return; 
+            }
+            const OptionMask& option = masks[index][k];
+            if (option.Cells.intersects(blocked)) {
+                continue;
+            }
+            CellMask next_blocked = blocked;
+            next_blocked |= option.Blocked;
+            size_t mark = path.size();
+            path.insert(path.end(), groups[index][k].begin(), groups[index][k].end());
+            backtrack(index + 1, next_blocked);
+            path.resize(mark);
+            if (cancel.load()) {
+                return;
+            } 
+        }
+    };
+    backtrack(0, CellMask{});
+}
+
+// Generates combinations in a separate thread, with cancellation support
+// doneHandler is called once the generator stops, whether it was exhausted or cancelled.
+std::thread Combs(
+    std::atomic<bool>& cancel,
+    const std::vector<Sector>& sectors,
+    const std::vector<Cell> cells,
+    std::function<void(const std::vector<Cell>)> resultHandler,
+    std::function<void()> doneHandler,
+    GroupEstimate* estimate
+) {
+    thread generator_thread([&cancel, sectors, cells, resultHandler, doneHandler, estimate]() {
+        try {
+            generateCombs(cancel, sectors, cells, resultHandler, estimate);
         } catch (const exception& e) {
             cerr << "Exception in Combs generator thread: " << e.what() << endl;
         } catch (...) {
             cerr << "Unknown exception in Combs generator thread." << endl;
         }
+        if (doneHandler) {
+            doneHandler();
+        }
     }); 
     return generator_thread;
-}
\ No newline at end of file
+}
@@ -1,15 +1,53 @@
 #pragma once
 #include "sector.h"
 #include "cell.h"
+#include "cellmask.h"
+#include "roomgraph.h"
 #include <thread>
 #include <atomic>
 #include <vector>
 #include <functional>
 
+class WorkerPool;
+
+// Upper bound on the number of leaf combinations the generator enumerates.
+constexpr long long GeneratorLimit = 100'000'000LL;
+
+bool roomGroups(
+    std::atomic<bool>& cancel,
+    const std::vector<Sector>& sectors,
+    std::vector<std::vector<std::vector<Cell>>>& groups,
+    GroupEstimate* estimate = nullptr,
+    WorkerPool* pool = nullptr,
+    int helpers = 1
+);
+
+// OptionMask is one room option: its cells and the cells it blocks (itself and the orthogonal neighbors).
+struct OptionMask {
+    CellMask Cells;
+    CellMask Blocked;
+};
+
+std::vector<std::vector<OptionMask>> optionMasks(
+    const std::vector<std::vector<std::vector<Cell>>>& groups,
+    const std::vector<Cell>& cells
+);
+
+void generateCombs(
+    std::atomic<bool>& cancel,
+    const std::vector<Sector>& sectors,
+    const std::vector<Cell>& cells,
+    const std::function<void(const std::vector<Cell>)>& resultHandler,
+    GroupEstimate* estimate = nullptr,
+    WorkerPool* pool = nullptr,
+    int helpers = 1
+);
 
 std::thread Combs(
     std::atomic<bool>& cancel,
     const std::vector<Sector>& sectors,
     const std::vector<Cell> cells,
-    std::function<void(const std::vector<Cell>)> resultHandler
+    std::function<void(const std::vector<Cell>)> resultHandler,
+    std::function<void()> doneHandler = nullptr,
+    GroupEstimate* estimate = nullptr
 );
\ No newline at end of file
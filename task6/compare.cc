@@ -0,0 +1,64 @@
+#include "heyawake.h"
+#include "initalBoards.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// compare solves every built-in board with each engine and prints one line per run, so engines
+// can be compared side by side on the same corpus.
+//
+//   compare.out [--deadline MS] [--threads N] [ENGINE...]
+//
+// Without engine names every registered engine runs. The deadline (10 s by default) keeps slow
+// engines from stalling the table.
+int main(int argc, char** argv) {
+    SolveOptions options;
+    options.Deadline = chrono::milliseconds(10000);
+    vector<string> names;
+    for (int a = 1; a < argc; ++a) {
+        string arg = argv[a];
+        if (arg == "--deadline" && a + 1 < argc) {
+            options.Deadline = chrono::milliseconds(atoi(argv[++a]));
+        } else if (arg == "--threads" && a + 1 < argc) {
+            options.Threads = atoi(argv[++a]);
+        } else {
+            names.push_back(arg);
+        }
+    }
+    if (names.empty()) {
+        for (const auto& engine : engines()) {
+            names.push_back(engine.Name);
+        }
+    }
+    for (const auto& name : names) {
+        if (findEngine(name) == nullptr) {
+            cerr << "Unknown engine " << name << ", registered:";
+            for (const auto& engine : engines()) {
+                cerr << " " << engine.Name;
+            }
+            cerr << endl;
+            return 1;
+        }
+    }
+
+    const char* statuses[] = {"solved", "unsat", "timeout", "invalid"};
+    printf("%-6s %-14s %-8s %10s %12s %12s\n", "board", "engine", "status", "seconds", "nodes", "table hits");
+    for (const auto& name : names) {
+        options.Engine = name;
+        // One context per engine, reused for every board, as a long-running caller would.
+        SolverContext context(options);
+        for (size_t i = 0; i < builtinPuzzleCount(); ++i) {
+            auto start = chrono::steady_clock::now();
+            SolveResult result = solve(builtinPuzzle(i), options, context);
+            chrono::duration<double> took = chrono::steady_clock::now() - start;
+            printf("%-6zu %-14s %-8s %10.3f %12llu %12llu\n", i + 1, name.c_str(),
+                statuses[static_cast<int>(result.Status)], took.count(),
+                static_cast<unsigned long long>(result.Stats.Nodes),
+                static_cast<unsigned long long>(result.Stats.TableHits));
+        }
+    }
+}
@@ -0,0 +1,127 @@
+#include "context.h"
+#include "board.h"
+#include "session.h"
+#include "solutioncache.h"
+#include "trace.h"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+using namespace std;
+
+SolverContext::SolverContext(const SolveOptions& options)
+    : Options(options), DeadStates(options.TableBytes) {}
+
+int SolverContext::threads() const {
+    return Options.Threads > 0 ? Options.Threads : max(1u, thread::hardware_concurrency());
+}
+
+void SolverContext::reset() {
+    DeadStates.nextGeneration();
+    for (auto& arena : arenas) {
+        arena->release();
+    }
+}
+
+// arena creates the arenas lazily, so they must all be requested before the workers start.
+ScratchArena* SolverContext::arena(int worker) {
+    while (arenas.size() <= static_cast<size_t>(worker)) {
+        arenas.push_back(make_unique<ScratchArena>());
+    }
+    return arenas[worker].get();
+}
+
+// solve answers from Options.Cache when it knows the board and records what the search proves.
+SolveResult SolverContext::solve(Board& board) {
+    if (Options.Cache != nullptr) {
+        SolveResult cached;
+        if (Options.Cache->lookup(board, cached)) {
+            cached.Stats.Cached = true;
+            return cached;
+        }
+    }
+#ifdef HEYAWAKE_TRACE
+    if (!Options.TracePath.empty()) {
+        startTrace();
+    }
+#endif
+    SolveResult result = search(board);
+#ifdef HEYAWAKE_TRACE
+    if (!Options.TracePath.empty()) {
+        stopTrace();
+        if (!writeChromeTrace(Options.TracePath)) {
+            cerr << "Could not write trace " << Options.TracePath << endl;
+        }
+    }
+#endif
+    if (Options.Cache != nullptr) {
+        Options.Cache->record(board, result);
+    }
+    return result;
+}
+
+SolveResult SolverContext::search(Board& board) {
+    reset();
+    SolveSession session(*this);
+    session.Result.Stats.Threads = threads();
+    for (int w = 0; w < session.Result.Stats.Threads; ++w) {
+        arena(w);
+    }
+    if (Options.Deterministic) {
+        return board.solveDeterministic(Options, session);
+    }
+    switch (Options.Mode) {
+    case SearchMode::PrefixTree:
+        return board.solvePrefixTree(Options, session);
+    case SearchMode::Portfolio:
+        return board.solvePortfolio(Options, session);
+    default:
+        return board.solveLeaves(Options, session);
+    }
+}
+
+void SolverContext::run(Board& board) {
+    SolveResult result = solve(board);
+    Board shown = board.copy();
+    shown.setFilled(result.Filled);
+    switch (result.Status) {
+    case SolveStatus::Solved:
+        cout << "Result:";
+        cout << shown.display();
+        if (result.Stats.Cached) {
+            cout << "Solution taken from the solution cache" << endl;
+            return;
+        }
+        cout << "Solution found by worker: " << result.Stats.Worker << endl;
+        break;
+    case SolveStatus::Unsat:
+        cout << "The board has no solution" << endl;
+        if (result.Stats.Cached) {
+            return;
+        }
+        break;
+    case SolveStatus::Timeout:
+        cout << "Time limit reached, best partial assignment:";
+        cout << shown.display();
+        break;
+    case SolveStatus::Invalid:
+        cout << "The board cannot be solved" << endl;
+        return;
+    }
+	cout << "Total combinations processed: " << result.Stats.Combinations << endl;
+    cout << "Room combinations: " << result.Stats.RawProduct << " raw, about " << result.Stats.PrunedProduct
+         << " after adjacency pruning" << endl;
+    cout << "Search nodes: " << result.Stats.Nodes << ", pruned by table: " << result.Stats.TableHits << endl;
+    if (Options.Deterministic) {
+        cout << "Workers: " << result.Stats.Threads << ", fixed tasks: " << result.Stats.Tasks
+             << ", solution in task: " << result.Stats.WinningTask << endl;
+    } else if (Options.Mode == SearchMode::Leaves) {
+        cout << "Workers: " << result.Stats.Threads << ", queue depth max: " << result.Stats.MaxQueueDepth
+             << ", mean: " << result.Stats.MeanQueueDepth << endl;
+        cout << "Batches: " << result.Stats.Batches << ", size mean: " << result.Stats.MeanBatch
+             << ", max: " << result.Stats.MaxBatch << endl;
+    } else if (Options.Mode == SearchMode::Portfolio) {
+        cout << "Workers: " << result.Stats.Threads << ", restarts: " << result.Stats.Restarts << endl;
+    } else {
+        cout << "Workers: " << result.Stats.Threads << ", subtrees handed to idle workers: " << result.Stats.Splits << endl;
+    }
+}
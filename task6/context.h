@@ -0,0 +1,42 @@
+#pragma once
+#include "arena.h"
+#include "options.h"
+#include "pool.h"
+#include "result.h"
+#include "zobrist.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class Board;
+
+// SolverContext holds what outlives one puzzle: the worker threads, the dead-state table and a
+// scratch arena per worker. Keep one context to solve a stream of puzzles; switching puzzles
+// costs O(1) in the board and table size. The rectangle placement tables (placement.h) are
+// process-wide and shared by all contexts.
+class SolverContext {
+    public:
+        explicit SolverContext(const SolveOptions& options = SolveOptions());
+        SolverContext(const SolverContext&) = delete;
+        SolverContext& operator=(const SolverContext&) = delete;
+
+        // Options apply to the next solve; TableBytes only takes effect in the constructor.
+        SolveOptions Options;
+        WorkerPool Pool;
+        TranspositionTable DeadStates;
+
+        // solve resets the context and solves board with Options, unless Options.Cache has it.
+        SolveResult solve(Board& board);
+        // run solves board and prints the result and statistics.
+        void run(Board& board);
+        // reset forgets the previous puzzle: the table moves to a new generation and the arenas are released.
+        void reset();
+        // arena is the scratch memory of worker w during one solve.
+        ScratchArena* arena(int worker);
+        int threads() const;
+
+    private:
+        SolveResult search(Board& board);
+
+        std::vector<std::unique_ptr<ScratchArena>> arenas;
+};
@@ -0,0 +1,78 @@
+#include "bitboard.h"
+#include "placement.h"
+#include "server.h"
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+using namespace std;
+
+namespace {
+
+SolverServer* running = nullptr;
+
+void onSignal(int) {
+    if (running != nullptr) {
+        running->stop();
+    }
+}
+
+}
+
+// heyawaked serves solve requests on a Unix socket until SIGINT or SIGTERM.
+//
+//   daemon.out [--socket PATH] [--workers N] [--threads N] [--deadline MS] [--table-mb N]
+//              [--placement-cache FILE] [--solution-cache FILE] [--kernel portable|avx2]
+int main(int argc, char** argv) {
+    ServerOptions options;
+    string placementCache;
+    for (int a = 1; a + 1 < argc; a += 2) {
+        string arg = argv[a];
+        string value = argv[a + 1];
+        if (arg == "--socket") {
+            options.SocketPath = value;
+        } else if (arg == "--workers") {
+            options.Workers = atoi(value.c_str());
+        } else if (arg == "--threads") {
+            options.ThreadsPerSolve = atoi(value.c_str());
+        } else if (arg == "--table-mb") {
+            options.TableBytes = size_t(atoi(value.c_str())) << 20;
+        } else if (arg == "--deadline") {
+            options.DefaultDeadline = chrono::milliseconds(atoi(value.c_str()));
+        } else if (arg == "--placement-cache") {
+            placementCache = value;
+        } else if (arg == "--solution-cache") {
+            options.SolutionCachePath = value;
+        } else if (arg == "--kernel" && (value == "portable" || value == "avx2")) {
+            if (setWhiteKernel(value == "avx2" ? WhiteKernel::Avx2 : WhiteKernel::Portable) != WhiteKernel::Avx2 && value == "avx2") {
+                cerr << "This CPU has no AVX2, using the portable kernel" << endl;
+            }
+        } else {
+            cerr << "Unknown option " << arg << endl;
+            return 1;
+        }
+    }
+    if (!placementCache.empty()) {
+        loadPlacementCache(placementCache);
+    }
+    ServerStats stats;
+    {
+        SolverServer server(options);
+        if (!server.start()) {
+            return 1;
+        }
+        running = &server;
+        signal(SIGINT, onSignal);
+        signal(SIGTERM, onSignal);
+        cout << "Listening on " << options.SocketPath << endl;
+        server.serve();
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+        running = nullptr;
+        stats = server.stats();
+    }
+    cout << "Requests: " << stats.Requests << ", from cache: " << stats.CacheHits << endl;
+    if (!placementCache.empty() && !savePlacementCache(placementCache)) {
+        cerr << "Could not write placement cache " << placementCache << endl;
+    }
+}
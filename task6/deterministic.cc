@@ -0,0 +1,188 @@
+#include "board.h"
+#include "combination.h"
+#include "session.h"
+#include <atomic>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+using namespace std;
+
+namespace {
+
+// The fixed partition aims at this many tasks per worker, so that a slow task does not hold
+// the rest back.
+constexpr size_t TasksPerThread = 8;
+// Each worker has a private dead-state table of this size, cleared before every task.
+constexpr size_t TaskTableBytes = 1u << 20;
+
+// prefixTasks lists the compatible option choices for the first groups, in tree order, going one
+// level deeper until there are at least want of them or no level is left.
+vector<vector<size_t>> prefixTasks(const vector<vector<OptionMask>>& masks, size_t want) {
+    vector<vector<size_t>> tasks{{}};
+    vector<CellMask> blocked{CellMask{}};
+    for (size_t level = 0; level < masks.size() && tasks.size() < want; ++level) {
+        vector<vector<size_t>> nextTasks;
+        vector<CellMask> nextBlocked;
+        for (size_t t = 0; t < tasks.size(); ++t) {
+            for (size_t k = 0; k < masks[level].size(); ++k) {
+                if (masks[level][k].Cells.intersects(blocked[t])) {
+                    continue;
+                }
+                nextTasks.push_back(tasks[t]);
+                nextTasks.back().push_back(k);
+                nextBlocked.push_back(blocked[t]);
+                nextBlocked.back() |= masks[level][k].Blocked;
+            }
+        }
+        tasks = std::move(nextTasks);
+        blocked = std::move(nextBlocked);
+    }
+    return tasks;
+}
+
+}
+
+// solveDeterministic splits the room combination tree into a fixed list of prefix tasks and
+// keeps the solution of the lowest task, so the result does not depend on which worker is
+// faster. A task only sees its own dead-state table, so its node count does not either. Tasks
+// are started in order; once task w has a solution, tasks after w are stopped and tasks before
+// it still run to the end. Stats.Nodes and Stats.TableHits count the tasks up to the winner.
+SolveResult Board::solveDeterministic(const SolveOptions& options, SolveSession& session) {
+    int threads = session.Result.Stats.Threads;
+    atomic<bool>& cancel = session.Cancel;
+    constexpr size_t None = numeric_limits<size_t>::max();
+
+    vector<vector<vector<Cell>>> groups;
+    vector<vector<OptionMask>> masks;
+    vector<vector<size_t>> tasks;
+    GroupEstimate estimate;
+    WorkerPool& pool = session.Context.Pool;
+
+    // taskNodes and taskHits are written by the one worker that ran the task.
+    vector<uint64_t> taskNodes, taskHits;
+    atomic<size_t> nextTask{0};
+    atomic<size_t> best{None};
+    mutex bestMutex;
+    int bestWorker = 0;
+    Board bestBoard = copy();
+    // running[w] is the task worker w is on, stops[w] stops it when a lower task wins.
+    unique_ptr<atomic<size_t>[]> running(new atomic<size_t>[threads]);
+    unique_ptr<atomic<bool>[]> stops(new atomic<bool>[threads]);
+    for (int t = 0; t < threads; ++t) {
+        running[t].store(None);
+        stops[t].store(false);
+    }
+    // A worker between tasks (None) is not stopped: it checks best itself after storing its next
+    // task, and a stop set now would cut short a task below the winner.
+    auto stopAfter = [&](size_t winner) {
+        for (int t = 0; t < threads; ++t) {
+            size_t task = running[t].load();
+            if (task != None && task > winner) {
+                stops[t].store(true);
+            }
+        }
+    };
+
+    auto workerLoop = [&](int worker) {
+        Board board = copy();
+        session.attach(board);
+        TranspositionTable table(options.DeadStateTable ? TaskTableBytes : 0);
+        if (options.DeadStateTable) {
+            board.DeadStates = &table;
+        }
+        board.Scratch = session.Context.arena(worker);
+        atomic<bool>& stop = stops[worker];
+        try {
+            for (size_t t = nextTask.fetch_add(1); t < tasks.size() && !cancel.load(); t = nextTask.fetch_add(1)) {
+                running[worker].store(t);
+                if (t > best.load()) {
+                    break;
+                }
+                board.cleanFilled();
+                table.clear();
+                board.Steps = 0;
+                board.Hits = 0;
+                vector<vector<int>> applied(tasks[t].size());
+                CellMask blocked;
+                bool placed = true;
+                for (size_t level = 0; level < tasks[t].size() && placed; ++level) {
+                    size_t k = tasks[t][level];
+                    placed = board.addOption(groups[level][k], applied[level]);
+                    blocked |= masks[level][k].Blocked;
+                }
+                bool solved = placed && board.searchRooms(stop, groups, masks, nullptr, tasks[t].size(), blocked);
+                taskNodes[t] = board.Steps;
+                taskHits[t] = board.Hits;
+                if (solved) {
+                    lock_guard<mutex> lock(bestMutex);
+                    if (t < best.load()) {
+                        best.store(t);
+                        bestWorker = worker;
+                        bestBoard = board;
+                        stopAfter(t);
+                    }
+                }
+            }
+        } catch (const exception& e) {
+            cerr << "Exception in deterministic worker thread: " << e.what() << endl;
+            session.fail();
+        } catch (...) {
+            cerr << "Unknown exception in deterministic worker thread." << endl;
+            session.fail();
+        }
+        running[worker].store(None);
+        session.workerDone();
+    };
+
+    // The tasks are built off the calling thread so the deadline also covers the room enumeration.
+    // The setup job counts as a worker until the real workers are started.
+    session.workerStarted();
+    pool.submit([&]() {
+        try {
+            if (roomGroups(cancel, Sectors, groups, &estimate, &pool, threads)) {
+                masks = optionMasks(groups, Cells);
+                tasks = prefixTasks(masks, TasksPerThread * threads);
+                taskNodes.assign(tasks.size(), 0);
+                taskHits.assign(tasks.size(), 0);
+                for (int t = 0; t < threads; ++t) {
+                    session.workerStarted();
+                    pool.submit([&workerLoop, t]() { workerLoop(t); });
+                }
+            }
+        } catch (const exception& e) {
+            cerr << "Exception in deterministic setup thread: " << e.what() << endl;
+            session.fail();
+        } catch (...) {
+            cerr << "Unknown exception in deterministic setup thread." << endl;
+            session.fail();
+        }
+        session.workerDone();
+    });
+    bool timedOut = session.wait();
+    for (int t = 0; t < threads; ++t) {
+        stops[t].store(true);
+    }
+    pool.wait();
+
+    size_t winner = best.load();
+    // A deadline or node budget may have stopped a task before the winner, so the winner is only
+    // kept when the search ran to the end.
+    if (winner != None && !timedOut && !session.Progress.BudgetExceeded.load()) {
+        session.publish(bestBoard, bestWorker);
+        session.Result.Stats.WinningTask = static_cast<int>(winner);
+    }
+    SolveResult result = session.finish(timedOut);
+    size_t counted = winner != None ? winner + 1 : tasks.size();
+    result.Stats.Nodes = 0;
+    result.Stats.TableHits = 0;
+    for (size_t t = 0; t < counted; ++t) {
+        result.Stats.Nodes += taskNodes[t];
+        result.Stats.TableHits += taskHits[t];
+    }
+    result.Stats.Tasks = static_cast<int>(tasks.size());
+    result.Stats.RawProduct = estimate.RawProduct;
+    result.Stats.PrunedProduct = estimate.PrunedProduct;
+    return result;
+}
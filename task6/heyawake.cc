@@ -0,0 +1,72 @@
+#include "heyawake.h"
+#include "board.h"
+#include <vector>
+using namespace std;
+
+const vector<Engine>& engines() {
+    static const vector<Engine> registry = {
+        {"tree", "workers walk the room combination tree and split subtrees for idle workers",
+            [](SolveOptions& options) {
+                options.Mode = SearchMode::PrefixTree;
+                options.Deterministic = false;
+            }},
+        {"leaves", "the Combs generator feeds full room combinations to fill workers in batches",
+            [](SolveOptions& options) {
+                options.Mode = SearchMode::Leaves;
+                options.Deterministic = false;
+            }},
+        {"portfolio", "workers race differently seeded configurations with Luby restarts",
+            [](SolveOptions& options) {
+                options.Mode = SearchMode::Portfolio;
+                options.Deterministic = false;
+            }},
+        {"deterministic", "fixed prefix tasks, the lowest solved task wins",
+            [](SolveOptions& options) {
+                options.Deterministic = true;
+            }},
+        // leaves-notable is the leaves engine with one combination per batch and no dead-state
+        // table. It is not the task6.cc algorithm: the room ordering, the parallel room
+        // enumeration, subtree splitting and the bitboard checks all stay on.
+        {"leaves-notable", "the leaves engine with one combination per batch and no dead-state table",
+            [](SolveOptions& options) {
+                options.Mode = SearchMode::Leaves;
+                options.Deterministic = false;
+                options.DeadStateTable = false;
+                options.BatchSize = 1;
+            }},
+    };
+    return registry;
+}
+
+const Engine* findEngine(const string& name) {
+    for (const auto& engine : engines()) {
+        if (engine.Name == name) {
+            return &engine;
+        }
+    }
+    return nullptr;
+}
+
+SolveResult solve(const Puzzle& puzzle, const SolveOptions& options) {
+    SolverContext context(options);
+    return solve(puzzle, options, context);
+}
+
+SolveResult solve(const Puzzle& puzzle, const SolveOptions& options, SolverContext& context) {
+    SolveResult invalid;
+    invalid.Status = SolveStatus::Invalid;
+    SolveOptions configured = options;
+    if (!options.Engine.empty()) {
+        const Engine* engine = findEngine(options.Engine);
+        if (engine == nullptr) {
+            return invalid;
+        }
+        engine->Configure(configured);
+    }
+    Board board{vector<Cell>(), vector<Sector>()};
+    if (!loadPuzzle(puzzle, board) || !board.isCorrect()) {
+        return invalid;
+    }
+    context.Options = configured;
+    return context.solve(board);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "context.h"
+#include "options.h"
+#include "puzzle.h"
+#include "result.h"
+#include <string>
+#include <vector>
+
+// heyawake.h is the interface of libheyawake: solve a Puzzle with one of the registered engines.
+// Every engine runs on the same boards and kernels, so engines can be compared in one binary.
+
+// Engine is one entry of the registry. Configure sets the search fields of the options for the
+// engine; limits such as Deadline, NodeBudget and Threads keep the caller's values.
+struct Engine {
+    std::string Name;
+    std::string Description;
+    void (*Configure)(SolveOptions& options);
+};
+
+// engines lists the registered engines, the default first.
+const std::vector<Engine>& engines();
+// findEngine returns the engine called name, or nullptr.
+const Engine* findEngine(const std::string& name);
+
+// solve loads puzzle and solves it with options.Engine, or with the options as given when Engine
+// is empty. The status is Invalid when the puzzle does not load or the engine is unknown.
+SolveResult solve(const Puzzle& puzzle, const SolveOptions& options = SolveOptions());
+// This overload reuses the threads and tables of context; its Options are replaced by the call.
+SolveResult solve(const Puzzle& puzzle, const SolveOptions& options, SolverContext& context);
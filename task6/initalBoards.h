@@ -1,11 +1,7 @@
 #pragma once
-#include <memory>
-#include "board.h"
+#include "puzzle.h"
+#include <cstddef>
 
-std::shared_ptr<int> ptrTo(int i);
-
-extern Board testCase1;
-extern Board testCase2;
-extern Board testCase3;
-extern Board testCase4;
-extern Board testCase5;
\ No newline at end of file
+// builtinPuzzle returns built-in puzzle i, for i < builtinPuzzleCount(); load it with loadPuzzle.
+const Puzzle& builtinPuzzle(size_t i);
+size_t builtinPuzzleCount();
@@ -0,0 +1,133 @@
+#include "client.h"
+#include "initalBoards.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// loadgen drives the daemon from several connections, each keeping a number of requests in
+// flight, and prints the throughput and the latency percentiles.
+//
+//   loadgen.out [--socket PATH] [--connections N] [--requests N] [--pipeline N]
+//               [--boards 1,2,3] [--engine NAME] [--no-cache]
+//
+// --requests is per connection. The default boards are the ones that solve in well under a second.
+int main(int argc, char** argv) {
+    string socketPath = "/tmp/heyawake.sock";
+    string engine;
+    int connections = 4;
+    int perConnection = 50;
+    int pipeline = 4;
+    bool noCache = false;
+    vector<size_t> boards{1, 2, 3, 4};
+    for (int a = 1; a < argc; ++a) {
+        string arg = argv[a];
+        if (arg == "--socket" && a + 1 < argc) {
+            socketPath = argv[++a];
+        } else if (arg == "--connections" && a + 1 < argc) {
+            connections = max(1, atoi(argv[++a]));
+        } else if (arg == "--requests" && a + 1 < argc) {
+            perConnection = max(1, atoi(argv[++a]));
+        } else if (arg == "--pipeline" && a + 1 < argc) {
+            pipeline = max(1, atoi(argv[++a]));
+        } else if (arg == "--engine" && a + 1 < argc) {
+            engine = argv[++a];
+        } else if (arg == "--no-cache") {
+            noCache = true;
+        } else if (arg == "--boards" && a + 1 < argc) {
+            boards.clear();
+            string list = argv[++a];
+            for (size_t pos = 0; pos < list.size();) {
+                size_t comma = list.find(',', pos);
+                size_t number = atoi(list.substr(pos, comma - pos).c_str());
+                if (number >= 1 && number <= builtinPuzzleCount()) {
+                    boards.push_back(number);
+                }
+                pos = comma == string::npos ? list.size() : comma + 1;
+            }
+        } else {
+            cerr << "Unknown option " << arg << endl;
+            return 1;
+        }
+    }
+    if (boards.empty()) {
+        cerr << "No boards to send" << endl;
+        return 1;
+    }
+
+    mutex statsMutex;
+    vector<double> latencies;
+    int cached = 0, failed = 0;
+    atomic<bool> lost{false};
+    auto connection = [&](int c) {
+        SolverClient client;
+        if (!client.connect(socketPath)) {
+            lost.store(true);
+            return;
+        }
+        using Clock = chrono::steady_clock;
+        map<uint32_t, Clock::time_point> sent;
+        vector<double> mine;
+        int myCached = 0, myFailed = 0;
+        int next = 0, done = 0;
+        while (done < perConnection) {
+            while (next < perConnection && static_cast<int>(sent.size()) < pipeline) {
+                const Puzzle& puzzle = builtinPuzzle(boards[(c + next) % boards.size()] - 1);
+                PuzzleRequest request = makeRequest(puzzle, static_cast<uint32_t>(next), engine);
+                request.NoCache = noCache;
+                sent[request.Id] = Clock::now();
+                if (!client.send(request)) {
+                    lost.store(true);
+                    return;
+                }
+                next++;
+            }
+            PuzzleReply reply;
+            if (!client.receive(reply) || sent.count(reply.Id) == 0) {
+                lost.store(true);
+                return;
+            }
+            mine.push_back(chrono::duration<double, milli>(Clock::now() - sent[reply.Id]).count());
+            sent.erase(reply.Id);
+            myCached += reply.Cached;
+            myFailed += reply.Status != SolveStatus::Solved;
+            done++;
+        }
+        lock_guard<mutex> lock(statsMutex);
+        latencies.insert(latencies.end(), mine.begin(), mine.end());
+        cached += myCached;
+        failed += myFailed;
+    };
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int c = 0; c < connections; ++c) {
+        threads.emplace_back(connection, c);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (lost.load()) {
+        cerr << "Lost the connection to " << socketPath << endl;
+    }
+    if (latencies.empty()) {
+        return 1;
+    }
+    sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        return latencies[min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))];
+    };
+    printf("requests: %zu in %.3f s, %.1f per second\n", latencies.size(), seconds, latencies.size() / seconds);
+    printf("latency ms: p50 %.3f, p90 %.3f, p99 %.3f, max %.3f\n", percentile(0.5), percentile(0.9), percentile(0.99), latencies.back());
+    printf("from cache: %d, not solved: %d\n", cached, failed);
+    return lost.load() ? 1 : 0;
+}
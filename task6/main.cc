@@ -1,24 +1,112 @@
 #include "board.h"
+#include "heyawake.h"
 #include "initalBoards.h"
+#include "placement.h"
+#include "solutioncache.h"
+#include "stream.h"
 #include <chrono>
 #include <iostream>
 #include <thread>
 #include <condition_variable>
 #include <atomic>
 #include <vector>
+#include <string>
+#include <cstdlib>
 using namespace std;
 
-int main() {
-    vector<Board> boards = {testCase1, testCase2, testCase3, testCase4, testCase5};
+int main(int argc, char** argv) {
+    // --placement-cache FILE keeps the room placement tables between runs.
+    // --engine NAME picks a registered engine (heyawake.h), the default is the first one.
+    // --solution-cache FILE answers known boards from FILE and adds the new ones to it.
+    // --stream solves puzzle lines from stdin instead of the built-in boards (stream.h), with
+    // --unordered, --workers N, --threads N (per puzzle) and --deadline MS. --puzzles prints the built-in boards as lines.
+    // --kernel portable|avx2 picks the dynamic bitboard kernels (bitboard.h).
+    // --trace FILE writes a Chrome trace of each solve to FILE (make trace builds with tracing).
+    string placementCache;
+    SolveOptions options;
+    SolutionCache solutions;
+    StreamOptions stream;
+    bool streaming = false;
+    for (int a = 1; a < argc; ++a) {
+        string arg = argv[a];
+        if (arg == "--placement-cache" && a + 1 < argc) {
+            placementCache = argv[++a];
+        } else if (arg == "--engine" && a + 1 < argc) {
+            const Engine* engine = findEngine(argv[++a]);
+            if (engine == nullptr) {
+                cerr << "Unknown engine " << argv[a] << endl;
+                return 1;
+            }
+            engine->Configure(options);
+        } else if (arg == "--solution-cache" && a + 1 < argc) {
+            if (!solutions.open(argv[++a])) {
+                cerr << "Cannot open solution cache " << argv[a] << endl;
+                return 1;
+            }
+            options.Cache = &solutions;
+        } else if (arg == "--stream") {
+            streaming = true;
+        } else if (arg == "--unordered") {
+            stream.Unordered = true;
+        } else if (arg == "--workers" && a + 1 < argc) {
+            stream.Workers = atoi(argv[++a]);
+        } else if (arg == "--threads" && a + 1 < argc) {
+            stream.ThreadsPerSolve = atoi(argv[++a]);
+        } else if (arg == "--deadline" && a + 1 < argc) {
+            options.Deadline = chrono::milliseconds(atoi(argv[++a]));
+        } else if (arg == "--kernel" && a + 1 < argc) {
+            string kernel = argv[++a];
+            if (kernel == "avx2" && setWhiteKernel(WhiteKernel::Avx2) != WhiteKernel::Avx2) {
+                cerr << "This CPU has no AVX2, using the portable kernel" << endl;
+            } else if (kernel == "portable") {
+                setWhiteKernel(WhiteKernel::Portable);
+            } else if (kernel != "avx2") {
+                cerr << "Unknown kernel " << kernel << endl;
+                return 1;
+            }
+        } else if (arg == "--trace" && a + 1 < argc) {
+            options.TracePath = argv[++a];
+#ifndef HEYAWAKE_TRACE
+            cerr << "Built without HEYAWAKE_TRACE, --trace is ignored" << endl;
+#endif
+        } else if (arg == "--puzzles") {
+            for (size_t i = 0; i < builtinPuzzleCount(); i++) {
+                cout << formatPuzzleLine(builtinPuzzle(i)) << '\n';
+            }
+            return 0;
+        }
+    }
+    if (!placementCache.empty()) {
+        loadPlacementCache(placementCache);
+    }
+    if (streaming) {
+        // The stream solves several puzzles at once, but a trace covers one solve at a time.
+        if (!options.TracePath.empty()) {
+            cerr << "--trace is ignored with --stream" << endl;
+            options.TracePath.clear();
+        }
+        stream.Solve = options;
+        runStream(cin, cout, stream);
+        if (!placementCache.empty() && !savePlacementCache(placementCache)) {
+            cerr << "Could not write placement cache " << placementCache << endl;
+        }
+        return 0;
+    }
+    // One context serves all boards, so the threads and the dead-state table are reused.
+    SolverContext context(options);
 	cout << "Explanation: Black cells are marked with an 'x' and white cells are marked with a space." << endl;
 	cout << "The speed of execution depends on the complexity of the playing board" << endl;
-    for (size_t i = 0; i < boards.size(); i++) {
+    for (size_t i = 0; i < builtinPuzzleCount(); i++) {
 		cout << "Press Enter to get started solving board №" << i + 1;
 		cin.get();
-        boards[i].setNumbers();
+        Board board{vector<Cell>(), vector<Sector>()};
+        if (!loadPuzzle(builtinPuzzle(i), board)) {
+            cout << "This board cannot be loaded" << endl;
+            continue;
+        }
 		cout << "Initial board of the "<< i + 1 << " board";
-		cout << boards[i].display();
-        if (boards[i].isCorrect()) {
+		cout << board.display();
+        if (board.isCorrect()) {
             cout << "Board structure is correct" << endl;;
         } else {
             cout << "Board structure is incorrect" << endl;
@@ -28,10 +116,13 @@ int main() {
 		cout << "Solving..." << endl;;
         auto start = chrono::high_resolution_clock::now();
 
-        boards[i].run();
+        context.run(board);
 
         auto end = chrono::high_resolution_clock::now();
 		chrono::duration<double> duration = end - start;
         cout << "Finish solving in " << duration.count() / 60.0 << " minutes\n" << endl;
     }
+    if (!placementCache.empty() && !savePlacementCache(placementCache)) {
+        cerr << "Could not write placement cache " << placementCache << endl;
+    }
 }
\ No newline at end of file
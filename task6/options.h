@@ -0,0 +1,59 @@
+#pragma once
+#include "zobrist.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class SolutionCache;
+
+enum class SearchMode {
+    // Combs enumerates full room combinations and workers replay each leaf from a clean board.
+    Leaves,
+    // Workers walk the room combination tree themselves and split subtrees for idle workers.
+    PrefixTree,
+    // Workers race differently seeded configurations with restarts; the first solution wins.
+    Portfolio,
+};
+
+// SolveOptions configures one Board::solve call or a SolverContext.
+struct SolveOptions {
+    // Engine names an entry of the engine registry (heyawake.h) that sets the fields below when
+    // solving through the library; empty keeps them as they are.
+    std::string Engine;
+    SearchMode Mode = SearchMode::PrefixTree;
+    // Deterministic runs a fixed task partition and keeps the solution of the lowest task, so the
+    // same board and thread count always give the same solution and node count. Overrides Mode.
+    bool Deterministic = false;
+    // Memory budget of the dead-state transposition table shared by all workers.
+    size_t TableBytes = TranspositionTable::DefaultBytes;
+    // DeadStateTable false searches without the table, as the original solver did.
+    bool DeadStateTable = true;
+    // Cache is consulted before a solve and records solved and unsolvable results; it is
+    // shared, not owned, and may be nullptr.
+    SolutionCache* Cache = nullptr;
+    // TracePath names the Chrome trace file written after each search (trace.h); it is ignored
+    // unless the build defines HEYAWAKE_TRACE.
+    std::string TracePath;
+    // Wall-clock limit of the whole solve, zero means no limit.
+    std::chrono::milliseconds Deadline{0};
+    // Stop, when set by another thread, ends the solve as if its deadline had passed. It is
+    // shared, not owned, and may be nullptr.
+    const std::atomic<bool>* Stop = nullptr;
+    // Maximum number of search nodes over all workers, zero means no limit.
+    uint64_t NodeBudget = 0;
+    // Number of fill workers, zero means one per hardware thread.
+    int Threads = 0;
+    // Capacity of the queue between the combination generator and the workers.
+    size_t QueueCapacity = 1024;
+    // Maximum number of combinations a worker takes from the queue at once.
+    size_t BatchSize = 256;
+    // Wall time a fill worker aims to spend on one batch; the batch size follows the observed
+    // time per combination.
+    std::chrono::microseconds BatchTarget{100};
+    // Portfolio mode: the seed of the candidate orders, and the node budget of one restart that
+    // the Luby sequence multiplies.
+    uint64_t Seed = 0;
+    uint64_t RestartUnit = 4096;
+};
@@ -0,0 +1,145 @@
+#include "placement.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace {
+
+using PlacementKey = array<int, 3>;
+
+shared_mutex cacheMutex;
+map<PlacementKey, unique_ptr<vector<uint64_t>>> cache;
+
+const uint32_t CacheMagic = 0x48594131; // "HYA1"
+
+// buildPlacements walks the cells in row-major order and never takes a cell next to a taken one,
+// so only valid placements are visited.
+bool buildPlacements(int height, int width, int number, const atomic<bool>* cancel, vector<uint64_t>& res) {
+    int size = height * width;
+    function<bool(int, int, uint64_t)> backtrack;
+    backtrack = [&](int start, int left, uint64_t mask) {
+        if (left == 0) {
+            res.push_back(mask);
+            return true;
+        }
+        if (cancel != nullptr && cancel->load()) {
+            return false;
+        }
+        for (int pos = start; pos + left <= size; ++pos) {
+            int col = pos % width;
+            bool up = pos >= width && (mask >> (pos - width)) & 1;
+            bool before = col > 0 && (mask >> (pos - 1)) & 1;
+            if (up || before) {
+                continue;
+            }
+            if (!backtrack(pos + 1, left - 1, mask | (uint64_t(1) << pos))) {
+                return false;
+            }
+        }
+        return true;
+    };
+    return backtrack(0, number, 0);
+}
+
+}
+
+const vector<uint64_t>* rectPlacements(int height, int width, int number, const atomic<bool>* cancel) {
+    if (height <= 0 || width <= 0 || height * width > 64 || number < 0) {
+        return nullptr;
+    }
+    PlacementKey key = {width, height, number};
+    {
+        shared_lock<shared_mutex> lock(cacheMutex);
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            return it->second.get();
+        }
+    }
+    auto table = make_unique<vector<uint64_t>>();
+    if (!buildPlacements(height, width, number, cancel, *table)) {
+        return nullptr;
+    }
+    unique_lock<shared_mutex> lock(cacheMutex);
+    auto it = cache.find(key);
+    if (it == cache.end()) {
+        it = cache.emplace(key, std::move(table)).first;
+    }
+    return it->second.get();
+}
+
+// File layout: magic, table count, then per table width, height, number, mask count and the masks.
+// A file that does not match the layout is ignored as a whole: the tables are only added once
+// every one of them has been read, and no table may claim more masks than the file has left.
+bool loadPlacementCache(const string& path) {
+    ifstream in(path, ios::binary | ios::ate);
+    if (!in) {
+        return false;
+    }
+    uint64_t left = static_cast<uint64_t>(in.tellg());
+    in.seekg(0);
+    uint32_t magic = 0, count = 0;
+    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!in || magic != CacheMagic) {
+        return false;
+    }
+    left -= sizeof(magic) + sizeof(count);
+    vector<pair<PlacementKey, unique_ptr<vector<uint64_t>>>> tables;
+    for (uint32_t t = 0; t < count; ++t) {
+        int32_t header[3];
+        uint64_t size = 0;
+        in.read(reinterpret_cast<char*>(header), sizeof(header));
+        in.read(reinterpret_cast<char*>(&size), sizeof(size));
+        if (!in) {
+            return false;
+        }
+        left -= sizeof(header) + sizeof(size);
+        int width = header[0], height = header[1], number = header[2];
+        if (width <= 0 || height <= 0 || width > 64 || height > 64 || width * height > 64 || number < 0) {
+            return false;
+        }
+        if (size > left / sizeof(uint64_t)) {
+            return false;
+        }
+        auto table = make_unique<vector<uint64_t>>(size);
+        in.read(reinterpret_cast<char*>(table->data()), size * sizeof(uint64_t));
+        if (!in) {
+            return false;
+        }
+        left -= size * sizeof(uint64_t);
+        tables.emplace_back(PlacementKey{width, height, number}, std::move(table));
+    }
+    unique_lock<shared_mutex> lock(cacheMutex);
+    for (auto& table : tables) {
+        cache.emplace(table.first, std::move(table.second));
+    }
+    return true;
+}
+
+bool savePlacementCache(const string& path) {
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out) {
+        return false;
+    }
+    shared_lock<shared_mutex> lock(cacheMutex);
+    uint32_t count = static_cast<uint32_t>(cache.size());
+    out.write(reinterpret_cast<const char*>(&CacheMagic), sizeof(CacheMagic));
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    for (const auto& entry : cache) {
+        int32_t header[3] = {entry.first[0], entry.first[1], entry.first[2]};
+        uint64_t size = entry.second->size();
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.write(reinterpret_cast<const char*>(entry.second->data()), size * sizeof(uint64_t));
+    }
+    return static_cast<bool>(out);
+}
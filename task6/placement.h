@@ -0,0 +1,16 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// rectPlacements returns every set of number pairwise non-adjacent cells of a height x width
+// rectangle (height * width <= 64) as row-major bitmasks relative to the top-left cell.
+// Tables are built once per (width, height, number) and shared by all threads of the process.
+// Returns nullptr if cancel was set while the table was being built.
+const std::vector<uint64_t>* rectPlacements(int height, int width, int number, const std::atomic<bool>* cancel = nullptr);
+
+// loadPlacementCache adds the tables stored in path to the process cache.
+bool loadPlacementCache(const std::string& path);
+// savePlacementCache writes every table in the process cache to path.
+bool savePlacementCache(const std::string& path);
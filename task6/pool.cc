@@ -0,0 +1,61 @@
+#include "pool.h"
+#include <iostream>
+using namespace std;
+
+WorkerPool::~WorkerPool() {
+    {
+        lock_guard<mutex> lock(poolMutex);
+        stopping = true;
+    }
+    jobCV.notify_all();
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+void WorkerPool::submit(function<void()> job) {
+    lock_guard<mutex> lock(poolMutex);
+    jobs.push_back(std::move(job));
+    running++;
+    if (idle < jobs.size()) {
+        threads.emplace_back(&WorkerPool::loop, this);
+    }
+    jobCV.notify_one();
+}
+
+void WorkerPool::wait() {
+    unique_lock<mutex> lock(poolMutex);
+    doneCV.wait(lock, [&]{ return running == 0; });
+}
+
+size_t WorkerPool::size() const {
+    lock_guard<mutex> lock(poolMutex);
+    return threads.size();
+}
+
+void WorkerPool::loop() {
+    unique_lock<mutex> lock(poolMutex);
+    for (;;) {
+        idle++;
+        jobCV.wait(lock, [&]{ return stopping || !jobs.empty(); });
+        idle--;
+        if (jobs.empty()) {
+            return;
+        }
+        function<void()> job = std::move(jobs.front());
+        jobs.pop_front();
+        lock.unlock();
+        try {
+            job();
+        } catch (const exception& e) {
+            cerr << "Exception in pool thread: " << e.what() << endl;
+        } catch (...) {
+            cerr << "Unknown exception in pool thread." << endl;
+        }
+        lock.lock();
+        running--;
+        if (running == 0) {
+            doneCV.notify_all();
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// WorkerPool keeps its threads between solves. The search jobs of one solve wait for each other
+// (workers for the generator, the generator for queue space), so a job never waits for a free
+// thread: submit starts a new thread when none is idle, and the pool only grows.
+class WorkerPool {
+    public:
+        WorkerPool() = default;
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+        ~WorkerPool();
+
+        void submit(std::function<void()> job);
+        // wait blocks until every submitted job has returned.
+        void wait();
+        size_t size() const;
+
+    private:
+        void loop();
+
+        mutable std::mutex poolMutex;
+        std::condition_variable jobCV;
+        std::condition_variable doneCV;
+        std::deque<std::function<void()>> jobs;
+        std::vector<std::thread> threads;
+        size_t idle = 0;
+        size_t running = 0;
+        bool stopping = false;
+};
@@ -0,0 +1,184 @@
+#include "board.h"
+#include "combination.h"
+#include "session.h"
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <vector>
+using namespace std;
+
+namespace {
+
+// PortfolioConfig is what one portfolio worker varies: Combs walks the room combination tree
+// before filling instead of filling from an empty board, Table shares the dead-state table.
+struct PortfolioConfig {
+    bool Combs = false;
+    bool Table = true;
+};
+
+// luby returns the i-th term (from 1) of the Luby sequence 1 1 2 1 1 2 4 1 1 2 ...
+uint64_t luby(uint64_t i) {
+    for (;;) {
+        int k = 1;
+        while ((uint64_t(1) << k) - 1 < i) {
+            k++;
+        }
+        if ((uint64_t(1) << k) - 1 == i) {
+            return uint64_t(1) << (k - 1);
+        }
+        i -= (uint64_t(1) << (k - 1)) - 1;
+    }
+}
+
+// runSeed mixes the portfolio seed, the worker and the restart into a nonzero shuffle seed.
+uint64_t runSeed(uint64_t seed, int worker, int restart) {
+    uint64_t z = seed ^ zobristKey(worker) ^ zobristKey(-2 - restart);
+    return z != 0 ? z : 1;
+}
+
+}
+
+// solvePortfolio races one configuration per worker. Each worker restarts its search whenever
+// the Luby sequence times RestartUnit nodes are spent, with a new candidate order every run. A run
+// that ends without hitting its limit has searched everything and proves the board unsolvable.
+// The first solution, or proof, cancels the rest.
+SolveResult Board::solvePortfolio(const SolveOptions& options, SolveSession& session) {
+    int threads = session.Result.Stats.Threads;
+    atomic<bool>& cancel = session.Cancel;
+    uint64_t unit = max<uint64_t>(1, options.RestartUnit);
+
+    // stops are the per-run cancel flags. A run stops on its own limit without cancelling the
+    // solve, so Cancel is forwarded to them by stopAll.
+    unique_ptr<atomic<bool>[]> stops(new atomic<bool>[threads]);
+    for (int t = 0; t < threads; ++t) {
+        stops[t].store(false);
+    }
+    auto stopAll = [&]() {
+        cancel.store(true);
+        for (int t = 0; t < threads; ++t) {
+            stops[t].store(true);
+        }
+    };
+    atomic<int> restarts{0};
+
+    mutex groupsMutex;
+    condition_variable groupsCV;
+    bool groupsReady = false;
+    bool groupsFound = false;
+    vector<vector<vector<Cell>>> groups;
+    vector<vector<OptionMask>> masks;
+
+    // combsRun walks the room options in a shuffled order and fills every leaf.
+    auto combsRun = [&](Board& board, atomic<bool>& stop, uint64_t seed) {
+        vector<vector<size_t>> order(groups.size());
+        for (size_t g = 0; g < groups.size(); ++g) {
+            order[g].resize(groups[g].size());
+            iota(order[g].begin(), order[g].end(), 0);
+            for (size_t k = order[g].size(); k > 1; --k) {
+                seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                swap(order[g][k - 1], order[g][(seed >> 33) % k]);
+            }
+        }
+        return board.searchRooms(stop, groups, masks, &order, 0, CellMask{});
+    };
+
+    auto workerLoop = [&](int worker) {
+        PortfolioConfig config{worker % 2 == 1, (worker / 2) % 2 == 0};
+        atomic<bool>& stop = stops[worker];
+        Board board = copy();
+        session.attach(board);
+        board.Scratch = session.Context.arena(worker);
+        if (!config.Table) {
+            board.DeadStates = nullptr;
+        }
+        try {
+            if (config.Combs) {
+                unique_lock<mutex> lock(groupsMutex);
+                groupsCV.wait(lock, [&]{ return groupsReady || cancel.load(); });
+                if (!groupsFound) {
+                    session.workerDone();
+                    return;
+                }
+            }
+            for (int run = 1; !cancel.load(); ++run) {
+                stop.store(false);
+                if (cancel.load()) {
+                    break;
+                }
+                board.cleanFilled();
+                // The first run of worker 0 keeps the board order, every other run is shuffled.
+                board.Shuffle = worker == 0 && run == 1 ? 0 : runSeed(options.Seed, worker, run);
+                board.Steps = 0;
+                board.NodeLimit = luby(run) * unit;
+                bool solved = config.Combs ? combsRun(board, stop, board.Shuffle) : board.search(stop, true) && board.valid();
+                if (solved) {
+                    if (session.publish(board, worker)) {
+                        stopAll();
+                    }
+                    break;
+                }
+                if (!stop.load()) {
+                    stopAll();
+                    break;
+                }
+                if (!cancel.load()) {
+                    restarts.fetch_add(1);
+                }
+            }
+        } catch (const exception& e) {
+            cerr << "Exception in portfolio worker thread: " << e.what() << endl;
+            session.fail();
+        } catch (...) {
+            cerr << "Unknown exception in portfolio worker thread." << endl;
+            session.fail();
+        }
+        session.workerDone();
+    };
+
+    WorkerPool& pool = session.Context.Pool;
+    for (int t = 0; t < threads; ++t) {
+        session.workerStarted();
+        pool.submit([&workerLoop, t]() { workerLoop(t); });
+    }
+    // The Combs workers wait for the room groups; a room without placements proves the board
+    // unsolvable.
+    GroupEstimate estimate;
+    if (threads > 1) {
+        pool.submit([&]() {
+            bool found = false;
+            try {
+                found = roomGroups(cancel, Sectors, groups, &estimate);
+                if (found) {
+                    masks = optionMasks(groups, Cells);
+                } else if (!cancel.load()) {
+                    stopAll();
+                }
+            } catch (const exception& e) {
+                cerr << "Exception in portfolio generator thread: " << e.what() << endl;
+                session.fail();
+            } catch (...) {
+                cerr << "Unknown exception in portfolio generator thread." << endl;
+                session.fail();
+            }
+            lock_guard<mutex> lock(groupsMutex);
+            groupsReady = true;
+            groupsFound = found;
+            groupsCV.notify_all();
+        });
+    }
+
+    bool timedOut = session.wait();
+    {
+        lock_guard<mutex> lock(groupsMutex);
+        stopAll();
+        groupsCV.notify_all();
+    }
+    pool.wait();
+    session.Result.Stats.Restarts = restarts.load();
+    session.Result.Stats.RawProduct = estimate.RawProduct;
+    session.Result.Stats.PrunedProduct = estimate.PrunedProduct;
+    return session.finish(timedOut);
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// SearchProgress is shared by all workers of one solve: node accounting and the deepest state seen.
+struct SearchProgress {
+    uint64_t NodeBudget = 0;
+    std::atomic<uint64_t> Nodes{0};
+    std::atomic<uint64_t> TableHits{0};
+    std::atomic<bool> BudgetExceeded{false};
+
+    std::atomic<int> BestDepth{-1};
+    std::mutex BestMutex;
+    std::vector<int> BestFilled;
+};
@@ -0,0 +1,185 @@
+#include "protocol.h"
+#include <algorithm>
+#include <cerrno>
+#include <sys/socket.h>
+#include <unistd.h>
+using namespace std;
+
+namespace {
+
+void put(string& out, uint64_t value, int bytes) {
+    for (int b = 0; b < bytes; ++b) {
+        out.push_back(static_cast<char>(value >> (8 * b)));
+    }
+}
+
+// Reader takes little-endian fields from a payload; Ok turns false on the first short read.
+struct Reader {
+    const string& In;
+    size_t Pos = 0;
+    bool Ok = true;
+
+    uint64_t get(int bytes) {
+        if (Pos + bytes > In.size()) {
+            Ok = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int b = 0; b < bytes; ++b) {
+            value |= uint64_t(static_cast<unsigned char>(In[Pos++])) << (8 * b);
+        }
+        return value;
+    }
+
+    string bytes(size_t n) {
+        if (Pos + n > In.size()) {
+            Ok = false;
+            return string();
+        }
+        Pos += n;
+        return In.substr(Pos - n, n);
+    }
+};
+
+}
+
+Puzzle PuzzleRequest::puzzle() const {
+    return Puzzle{Rows, Cols, Rooms, Numbers.data(), Numbers.size()};
+}
+
+string PuzzleRequest::key() const {
+    string res;
+    put(res, Rows, 2);
+    put(res, Cols, 2);
+    put(res, Numbers.size(), 2);
+    res += Rooms;
+    for (int number : Numbers) {
+        put(res, static_cast<uint16_t>(number), 2);
+    }
+    return res;
+}
+
+PuzzleRequest makeRequest(const Puzzle& puzzle, uint32_t id, const string& engine, uint32_t deadlineMs) {
+    PuzzleRequest request;
+    request.Id = id;
+    request.Engine = engine;
+    request.DeadlineMs = deadlineMs;
+    request.Rows = puzzle.Rows;
+    request.Cols = puzzle.Cols;
+    request.Rooms = string(puzzle.Rooms);
+    request.Numbers.assign(puzzle.Numbers, puzzle.Numbers + puzzle.RoomCount);
+    return request;
+}
+
+string encodeRequest(const PuzzleRequest& request) {
+    string out;
+    put(out, request.Id, 4);
+    // The length has one byte, so a longer name is cut; no registered engine is that long.
+    size_t engineLength = min<size_t>(request.Engine.size(), 255);
+    put(out, engineLength, 1);
+    out += request.Engine.substr(0, engineLength);
+    put(out, request.DeadlineMs, 4);
+    put(out, request.NoCache ? 1 : 0, 1);
+    out += request.key();
+    return out;
+}
+
+bool decodeRequest(const string& payload, PuzzleRequest& request) {
+    Reader in{payload};
+    request.Id = static_cast<uint32_t>(in.get(4));
+    request.Engine = in.bytes(in.get(1));
+    request.DeadlineMs = static_cast<uint32_t>(in.get(4));
+    request.NoCache = (in.get(1) & 1) != 0;
+    request.Rows = static_cast<int>(in.get(2));
+    request.Cols = static_cast<int>(in.get(2));
+    size_t rooms = in.get(2);
+    request.Rooms = in.bytes(size_t(request.Rows) * request.Cols);
+    request.Numbers.resize(rooms);
+    for (auto& number : request.Numbers) {
+        number = static_cast<int16_t>(in.get(2));
+    }
+    return in.Ok && in.Pos == payload.size();
+}
+
+string encodeReply(const PuzzleReply& reply) {
+    string out;
+    put(out, reply.Id, 4);
+    put(out, static_cast<uint8_t>(reply.Status), 1);
+    put(out, reply.Cached ? 1 : 0, 1);
+    put(out, reply.Nodes, 8);
+    put(out, reply.Micros, 4);
+    put(out, reply.Filled.size(), 2);
+    for (int idx : reply.Filled) {
+        put(out, idx, 2);
+    }
+    return out;
+}
+
+bool decodeReply(const string& payload, PuzzleReply& reply) {
+    Reader in{payload};
+    reply.Id = static_cast<uint32_t>(in.get(4));
+    uint64_t status = in.get(1);
+    reply.Status = status <= static_cast<uint64_t>(SolveStatus::Invalid) ? static_cast<SolveStatus>(status) : SolveStatus::Invalid;
+    reply.Cached = in.get(1) != 0;
+    reply.Nodes = in.get(8);
+    reply.Micros = static_cast<uint32_t>(in.get(4));
+    reply.Filled.resize(in.get(2));
+    for (auto& idx : reply.Filled) {
+        idx = static_cast<int>(in.get(2));
+    }
+    return in.Ok && in.Pos == payload.size();
+}
+
+namespace {
+
+bool readAll(int fd, char* data, size_t n) {
+    while (n > 0) {
+        ssize_t got = read(fd, data, n);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+        data += got;
+        n -= got;
+    }
+    return true;
+}
+
+}
+
+bool readFrame(int fd, string& payload) {
+    unsigned char header[4];
+    if (!readAll(fd, reinterpret_cast<char*>(header), sizeof(header))) {
+        return false;
+    }
+    uint32_t length = header[0] | header[1] << 8 | header[2] << 16 | uint32_t(header[3]) << 24;
+    if (length > MaxFrameBytes) {
+        return false;
+    }
+    payload.resize(length);
+    return readAll(fd, &payload[0], length);
+}
+
+// The frame goes out in one send where possible; MSG_NOSIGNAL turns a closed peer into an error
+// instead of SIGPIPE.
+bool writeFrame(int fd, const string& payload) {
+    string frame;
+    put(frame, payload.size(), 4);
+    frame += payload;
+    const char* data = frame.data();
+    size_t n = frame.size();
+    while (n > 0) {
+        ssize_t sent = send(fd, data, n, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        n -= sent;
+    }
+    return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "puzzle.h"
+#include "result.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// The daemon protocol: every message is a frame of a 4-byte little-endian length followed by that
+// many payload bytes. A client may send several requests before reading; replies carry the id of
+// their request and may come back in any order.
+//
+// Request payload, little-endian:
+//   u32 id, u8 engine length, engine name, u32 deadline ms (0 = none), u8 flags (1 = skip cache),
+//   u16 rows, u16 cols, u16 room count, rows * cols room characters (see Puzzle),
+//   room count * i16 room numbers (-1 = no number)
+// Reply payload:
+//   u32 id, u8 status (SolveStatus), u8 cached, u64 nodes, u32 microseconds,
+//   u16 count, count * u16 black cells, as indexes of the puzzle cells in row-major order
+//   with the '.' positions skipped
+
+// Frames larger than this are rejected, the connection is closed.
+constexpr uint32_t MaxFrameBytes = 1u << 20;
+
+// PuzzleRequest owns the data that Puzzle only points to.
+struct PuzzleRequest {
+    uint32_t Id = 0;
+    std::string Engine;
+    uint32_t DeadlineMs = 0;
+    // NoCache solves the puzzle even if the daemon has its solution, for load tests.
+    bool NoCache = false;
+    int Rows = 0;
+    int Cols = 0;
+    std::string Rooms;
+    std::vector<int> Numbers;
+
+    Puzzle puzzle() const;
+    // key is the puzzle part of the request; equal keys are the same puzzle.
+    std::string key() const;
+};
+
+struct PuzzleReply {
+    uint32_t Id = 0;
+    SolveStatus Status = SolveStatus::Invalid;
+    bool Cached = false;
+    uint64_t Nodes = 0;
+    uint32_t Micros = 0;
+    std::vector<int> Filled;
+};
+
+PuzzleRequest makeRequest(const Puzzle& puzzle, uint32_t id, const std::string& engine = "", uint32_t deadlineMs = 0);
+
+std::string encodeRequest(const PuzzleRequest& request);
+bool decodeRequest(const std::string& payload, PuzzleRequest& request);
+std::string encodeReply(const PuzzleReply& reply);
+bool decodeReply(const std::string& payload, PuzzleReply& reply);
+
+// readFrame and writeFrame move one frame over a socket; both return false when the connection
+// is closed or broken.
+bool readFrame(int fd, std::string& payload);
+bool writeFrame(int fd, const std::string& payload);
@@ -0,0 +1,40 @@
+#include "puzzle.h"
+#include <vector>
+using namespace std;
+
+bool loadPuzzle(const Puzzle& puzzle, Board& board) {
+    if (puzzle.Rows <= 0 || puzzle.Cols <= 0 || puzzle.Rooms.size() != size_t(puzzle.Rows) * puzzle.Cols) {
+        return false;
+    }
+    if (puzzle.RoomCount > RoomNames.size()) {
+        return false;
+    }
+    vector<Cell> cells;
+    vector<Sector> sectors(puzzle.RoomCount);
+    cells.reserve(puzzle.Rooms.size());
+    for (int i = 0; i < puzzle.Rows; ++i) {
+        for (int j = 0; j < puzzle.Cols; ++j) {
+            char name = puzzle.Rooms[i * puzzle.Cols + j];
+            if (name == '.') {
+                continue;
+            }
+            size_t room = RoomNames.find(name);
+            if (room >= puzzle.RoomCount) {
+                return false;
+            }
+            Cell cell;
+            cell.i = i;
+            cell.j = j;
+            cells.push_back(cell);
+            sectors[room].Cells.push_back(cell);
+        }
+    }
+    for (size_t r = 0; r < sectors.size(); ++r) {
+        if (puzzle.Numbers[r] >= 0) {
+            sectors[r].Number = make_shared<int>(puzzle.Numbers[r]);
+        }
+    }
+    board = Board(std::move(cells), std::move(sectors));
+    board.setNumbers();
+    return true;
+}
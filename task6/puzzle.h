@@ -0,0 +1,22 @@
+#pragma once
+#include "board.h"
+#include <cstddef>
+#include <string_view>
+
+// Puzzle is a board as plain data, so it can be a constant. Rooms has one character per cell,
+// row by row: the name of the cell's room in RoomNames, or '.' where the board has no cell.
+// Numbers[r] is the number of room r, -1 for a room without a number.
+struct Puzzle {
+    int Rows = 0;
+    int Cols = 0;
+    std::string_view Rooms;
+    const int* Numbers = nullptr;
+    size_t RoomCount = 0;
+};
+
+// RoomNames maps room characters to room indexes: '0' is room 0, 'A' room 10, 'a' room 36.
+constexpr std::string_view RoomNames = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+// loadPuzzle builds a solver-ready board (setNumbers already called) from a puzzle. It returns
+// false if the sizes do not match or a cell names an unknown room.
+bool loadPuzzle(const Puzzle& puzzle, Board& board);
@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// BoundedQueue is a lock-free multi-producer multi-consumer ring buffer with a fixed capacity.
+// Every slot carries a sequence number that tells producers and consumers whose turn it is,
+// so tryPush fails instead of growing when the consumers fall behind.
+template <typename T>
+class BoundedQueue {
+    public:
+        // capacity is rounded up to a power of two.
+        explicit BoundedQueue(size_t capacity) {
+            size_t size = 2;
+            while (size < capacity) {
+                size *= 2;
+            }
+            mask = size - 1;
+            slots = std::make_unique<Slot[]>(size);
+            for (size_t i = 0; i < size; ++i) {
+                slots[i].Sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        bool tryPush(const T& value) {
+            size_t pos = head.load(std::memory_order_relaxed);
+            for (;;) {
+                Slot& slot = slots[pos & mask];
+                size_t seq = slot.Sequence.load(std::memory_order_acquire);
+                if (seq == pos) {
+                    if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        slot.Value = value;
+                        slot.Sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (seq < pos) {
+                    return false;
+                } else {
+                    pos = head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool tryPop(T& value) {
+            size_t pos = tail.load(std::memory_order_relaxed);
+            for (;;) {
+                Slot& slot = slots[pos & mask];
+                size_t seq = slot.Sequence.load(std::memory_order_acquire);
+                if (seq == pos + 1) {
+                    if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        value = slot.Value;
+                        slot.Sequence.store(pos + mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (seq < pos + 1) {
+                    return false;
+                } else {
+                    pos = tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // popBatch moves up to max items into out and returns how many were taken.
+        size_t popBatch(T* out, size_t max) {
+            size_t n = 0;
+            while (n < max && tryPop(out[n])) {
+                n++;
+            }
+            return n;
+        }
+
+        // size is approximate while other threads are pushing or popping.
+        size_t size() const {
+            size_t h = head.load(std::memory_order_relaxed);
+            size_t t = tail.load(std::memory_order_relaxed);
+            return h > t ? h - t : 0;
+        }
+
+        size_t capacity() const {
+            return mask + 1;
+        }
+
+    private:
+        struct Slot {
+            std::atomic<size_t> Sequence{0};
+            T Value{};
+        };
+        std::unique_ptr<Slot[]> slots;
+        size_t mask = 0;
+        alignas(64) std::atomic<size_t> head{0};
+        alignas(64) std::atomic<size_t> tail{0};
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class SolveStatus {
+    Solved,
+    Unsat,
+    Timeout,
+    // The puzzle could not be loaded or the engine is unknown, so nothing was searched, or a
+    // search thread failed with an error before a solution was found.
+    Invalid,
+};
+
+struct SolveStats {
+    // Cached is set when the result came from the solution cache without a search.
+    bool Cached = false;
+    uint64_t Nodes = 0;
+    uint64_t TableHits = 0;
+    int Combinations = 0;
+    int Worker = 0;
+    int Threads = 0;
+    int Splits = 0;
+    int Restarts = 0;
+    // Number of fixed tasks of the deterministic mode, and the task of the solution (-1 if none).
+    int Tasks = 0;
+    int WinningTask = -1;
+    size_t MaxQueueDepth = 0;
+    double MeanQueueDepth = 0;
+    // Batches the fill workers took from the queue, and their mean and largest size.
+    int Batches = 0;
+    double MeanBatch = 0;
+    size_t MaxBatch = 0;
+    double Seconds = 0;
+    // Size of the room combination product, raw and after the estimated adjacency pruning.
+    double RawProduct = 0;
+    double PrunedProduct = 0;
+};
+
+// SolveResult is returned by Board::solve.
+// Filled holds the solution cells when solved, otherwise the deepest partial assignment reached.
+struct SolveResult {
+    SolveStatus Status = SolveStatus::Unsat;
+    std::vector<int> Filled;
+    SolveStats Stats;
+};
@@ -0,0 +1,120 @@
+#include "roomgraph.h"
+#include "cell.h"
+#include "sector.h"
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <map>
+#include <vector>
+using namespace std;
+
+vector<vector<int>> roomAdjacency(const vector<Sector>& sectors) {
+    map<array<int, 2>, int> owner;
+    for (size_t s = 0; s < sectors.size(); ++s) {
+        sectors[s].forEachCell([&](const Cell& cell) {
+            owner[{cell.i, cell.j}] = static_cast<int>(s);
+        });
+    }
+    vector<vector<int>> adjacency(sectors.size());
+    for (size_t s = 0; s < sectors.size(); ++s) {
+        sectors[s].forEachCell([&](const Cell& cell) {
+            const array<array<int, 2>, 2> next = {{{cell.i + 1, cell.j}, {cell.i, cell.j + 1}}};
+            for (const auto& coord : next) {
+                auto it = owner.find(coord);
+                if (it == owner.end() || it->second == static_cast<int>(s)) {
+                    continue;
+                }
+                adjacency[s].push_back(it->second);
+                adjacency[it->second].push_back(static_cast<int>(s));
+            }
+        });
+    }
+    for (auto& list : adjacency) {
+        sort(list.begin(), list.end());
+        list.erase(unique(list.begin(), list.end()), list.end());
+    }
+    return adjacency;
+}
+
+// Each step takes the unplaced room nearest to the placed ones (BFS over all rooms, numbered or not),
+// then the one touching most placed rooms, then the one with fewer options.
+vector<int> roomOrder(const vector<vector<int>>& adjacency, const vector<int>& rooms, const vector<size_t>& sizes) {
+    size_t n = adjacency.size();
+    vector<bool> placed(n, false);
+    vector<int> order;
+    order.reserve(rooms.size());
+    vector<size_t> roomSize(n, 0);
+    for (size_t r = 0; r < rooms.size(); ++r) {
+        roomSize[rooms[r]] = sizes[r];
+    }
+
+    while (order.size() < rooms.size()) {
+        vector<int> dist(n, -1);
+        deque<int> frontier;
+        for (int room : order) {
+            dist[room] = 0;
+            frontier.push_back(room);
+        }
+        while (!frontier.empty()) {
+            int s = frontier.front();
+            frontier.pop_front();
+            for (int t : adjacency[s]) {
+                if (dist[t] < 0) {
+                    dist[t] = dist[s] + 1;
+                    frontier.push_back(t);
+                }
+            }
+        }
+        int best = -1;
+        int bestDist = 0, bestTouch = 0;
+        for (int room : rooms) {
+            if (placed[room]) {
+                continue;
+            }
+            // Unreachable rooms (or the first pick) fall back to the smallest room.
+            int d = dist[room] < 0 ? static_cast<int>(n) : dist[room];
+            int touch = 0;
+            for (int t : adjacency[room]) {
+                touch += placed[t] ? 1 : 0;
+            }
+            bool better = best < 0
+                || d < bestDist
+                || (d == bestDist && touch > bestTouch)
+                || (d == bestDist && touch == bestTouch && roomSize[room] < roomSize[best]);
+            if (better) {
+                best = room;
+                bestDist = d;
+                bestTouch = touch;
+            }
+        }
+        placed[best] = true;
+        order.push_back(best);
+    }
+    return order;
+}
+
+double compatibleRate(const vector<vector<Cell>>& a, const vector<vector<Cell>>& b) {
+    const size_t samples = 32;
+    size_t strideA = max<size_t>(1, a.size() / samples);
+    size_t strideB = max<size_t>(1, b.size() / samples);
+    size_t tested = 0, compatible = 0;
+    for (size_t x = 0; x < a.size(); x += strideA) {
+        for (size_t y = 0; y < b.size(); y += strideB) {
+            bool ok = true;
+            for (const auto& ca : a[x]) {
+                for (const auto& cb : b[y]) {
+                    if (ca.Equal(cb) || ca.NextTo(cb)) {
+                        ok = false;
+                        break;
+                    }
+                }
+                if (!ok) {
+                    break;
+                }
+            }
+            tested++;
+            compatible += ok ? 1 : 0;
+        }
+    }
+    return tested > 0 ? static_cast<double>(compatible) / tested : 1.0;
+}
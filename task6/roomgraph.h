@@ -0,0 +1,26 @@
+#pragma once
+#include "cell.h"
+#include "sector.h"
+#include <cstddef>
+#include <vector>
+
+// GroupEstimate compares the raw size of the room combination product with an estimate of what
+// is left after adjacency pruning between neighboring rooms.
+struct GroupEstimate {
+    double RawProduct = 0;
+    double PrunedProduct = 0;
+};
+
+// roomAdjacency returns, for every sector, the sorted list of sectors it shares an edge with.
+std::vector<std::vector<int>> roomAdjacency(const std::vector<Sector>& sectors);
+
+// roomOrder orders the rooms (sector indexes) so that each one is as close as possible to the
+// rooms placed before it in the adjacency graph, starting from the room with the fewest options.
+std::vector<int> roomOrder(
+    const std::vector<std::vector<int>>& adjacency,
+    const std::vector<int>& rooms,
+    const std::vector<size_t>& sizes
+);
+
+// compatibleRate estimates the fraction of option pairs of two rooms with no equal or touching cells.
+double compatibleRate(const std::vector<std::vector<Cell>>& a, const std::vector<std::vector<Cell>>& b);
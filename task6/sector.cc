@@ -2,11 +2,76 @@
 #include "sector.h"
 #include "cell.h"
 #include "validator.h"
+#include "shape.h"
+#include "placement.h"
 #include <functional>
 
-bool Sector::Contains(const Cell& cell) const {
-    if (Number == nullptr) {
-        return false;
+Sector Sector::Rect(int top, int left, int height, int width, std::shared_ptr<int> number) {
+    Sector sector;
+    sector.Number = std::move(number);
+    sector.Top = top;
+    sector.Left = left;
+    sector.Height = height;
+    sector.Width = width;
+    return sector;
+}
+
+bool Sector::isRect() const {
+    return Height > 0 && Width > 0;
+}
+
+void Sector::compact() {
+    if (isRect() || Cells.empty()) {
+        return;
+    }
+    Shape shape = shape.getShape(Cells);
+    int height = shape.MaxI - shape.MinI + 1;
+    int width = shape.MaxJ - shape.MinJ + 1;
+    if (Cells.size() != static_cast<size_t>(height) * width) {
+        return;
+    }
+    std::vector<bool> seen(Cells.size(), false);
+    for (const auto& cell : Cells) {
+        size_t pos = static_cast<size_t>(cell.i - shape.MinI) * width + (cell.j - shape.MinJ);
+        if (seen[pos]) {
+            return;
+        }
+        seen[pos] = true;
+    }
+    Top = shape.MinI;
+    Left = shape.MinJ;
+    Height = height;
+    Width = width;
+    Cells.clear();
+    Cells.shrink_to_fit();
+}
+
+size_t Sector::size() const {
+    return isRect() ? static_cast<size_t>(Height) * Width : Cells.size();
+}
+
+std::vector<Cell> Sector::cellList() const {
+    std::vector<Cell> res;
+    res.reserve(size());
+    forEachCell([&](const Cell& cell) {
+        res.push_back(cell);
+    });
+    return res;
+}
+
+Cell Sector::firstCell() const {
+    if (!isRect()) {
+        return Cells.empty() ? Cell() : Cells[0];
+    }
+    Cell cell;
+    cell.i = Top;
+    cell.j = Left;
+    return cell;
+}
+
+bool Sector::Includes(const Cell& cell) const {
+    if (isRect()) {
+        return cell.i >= Top && cell.i < Top + Height && cell.j >= Left && cell.j < Left + Width;
     }
     for (size_t i = 0; i < Cells.size(); ++i) {
         if (Cells[i].Equal(cell)) {
@@ -16,26 +81,93 @@ bool Sector::Contains(const Cell& cell) const {
     return false;
 }
 
-std::vector<std::vector<Cell>> Sector::Combs() const {
+bool Sector::OnBorder(const Cell& cell) const {
+    if (!Includes(cell)) {
+        return false;
+    }
+    if (isRect()) {
+        return cell.i == Top || cell.i == Top + Height - 1 || cell.j == Left || cell.j == Left + Width - 1;
+    }
+    const int di[4] = {-1, 1, 0, 0};
+    const int dj[4] = {0, 0, -1, 1};
+    for (int d = 0; d < 4; ++d) {
+        Cell next;
+        next.i = cell.i + di[d];
+        next.j = cell.j + dj[d];
+        if (!Includes(next)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Sector::Contains(const Cell& cell) const {
+    if (Number == nullptr) {
+        return false;
+    }
+    return Includes(cell);
+}
+
+// Combs stops early and returns a partial list when cancel is set.
+std::vector<std::vector<Cell>> Sector::Combs(const std::atomic<bool>* cancel) const {
     std::vector<std::vector<Cell>> res;
     if (Number == nullptr || *Number == 0) {
         return res;
     }
-    std::function<void(int, std::vector<Cell>)> backtrack;
-    backtrack = [&](int start, std::vector<Cell> path) {
-        if (path.size() == static_cast<size_t>(*Number)) {
-            std::vector<Cell> comb = path;
-            if (validComb(comb)) {
-                res.push_back(comb);
+    // Rectangular rooms are translated from the shared placement table of their shape.
+    Sector room = *this;
+    room.compact();
+    if (room.isRect() && room.Height * room.Width <= 64) {
+        int width = room.Width;
+        const std::vector<uint64_t>* table = rectPlacements(room.Height, width, *Number, cancel);
+        if (table == nullptr) {
+            return res;
+        }
+        res.reserve(table->size());
+        for (uint64_t mask : *table) {
+            std::vector<Cell> comb;
+            comb.reserve(*Number);
+            while (mask != 0) {
+                int bit = __builtin_ctzll(mask);
+                mask &= mask - 1;
+                Cell cell;
+                cell.i = room.Top + bit / width;
+                cell.j = room.Left + bit % width;
+                comb.push_back(cell);
             }
+            res.push_back(std::move(comb));
+        }
+        return res;
+    }
+    // Irregular rooms: a cell next to one already on the path is skipped right away, since
+    // validComb would reject every combination below it, and so are starts that leave too few cells.
+    size_t need = static_cast<size_t>(*Number);
+    std::vector<Cell> path;
+    path.reserve(need);
+    std::function<void(size_t)> backtrack;
+    backtrack = [&](size_t start) {
+        if (cancel != nullptr && cancel->load()) {
             return;
         }
-        for (size_t i = start; i < Cells.size(); ++i) {
-            std::vector<Cell> next_path = path;
-            next_path.push_back(Cells[i]);
-            backtrack(i + 1, next_path);
+        if (path.size() == need) {
+            if (validComb(path)) {
+                res.push_back(path);
+            }
+            return;
+        }
+        for (size_t i = start; i + (need - path.size()) <= room.Cells.size(); ++i) {
+            bool touches = false;
+            for (const auto& cell : path) {
+                touches = touches || cell.NextTo(room.Cells[i]);
+            }
+            if (touches) {
+                continue;
+            }
+            path.push_back(room.Cells[i]);
+            backtrack(i + 1);
+            path.pop_back();
         }
     };
-    backtrack(0, std::vector<Cell>{});
+    backtrack(0);
     return res;
 }
\ No newline at end of file
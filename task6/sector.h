@@ -2,11 +2,47 @@
 #include "cell.h"
 #include <vector>
 #include <memory>
+#include <atomic>
 
+// Sector is a room. A rectangular room is described by Top, Left, Height and Width and keeps
+// Cells empty; an irregular room (Height == 0) lists its cells explicitly.
 struct Sector {
     std::vector<Cell> Cells;
     std::shared_ptr<int> Number = nullptr;
+    int Top = 0, Left = 0;
+    int Height = 0, Width = 0;
 
+    static Sector Rect(int top, int left, int height, int width, std::shared_ptr<int> number = nullptr);
+
+    bool isRect() const;
+    // compact switches an explicit cell list that exactly covers a rectangle to the rectangle form.
+    void compact();
+    size_t size() const;
+    std::vector<Cell> cellList() const;
+    Cell firstCell() const;
+    // Includes reports membership regardless of the room number.
+    bool Includes(const Cell& cell) const;
+    // OnBorder reports whether a cell of the room touches a cell outside it.
+    bool OnBorder(const Cell& cell) const;
     bool Contains(const Cell& cell) const;
-    std::vector<std::vector<Cell>> Combs() const;
-};
\ No newline at end of file
+    std::vector<std::vector<Cell>> Combs(const std::atomic<bool>* cancel = nullptr) const;
+
+    // forEachCell calls f with every cell of the room, row by row for rectangles.
+    template <typename F>
+    void forEachCell(F f) const {
+        if (!isRect()) {
+            for (const auto& cell : Cells) {
+                f(cell);
+            }
+            return;
+        }
+        for (int i = Top; i < Top + Height; ++i) {
+            for (int j = Left; j < Left + Width; ++j) {
+                Cell cell;
+                cell.i = i;
+                cell.j = j;
+                f(cell);
+            }
+        }
+    }
+};
@@ -0,0 +1,201 @@
+#include "server.h"
+#include "context.h"
+#include "heyawake.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+using namespace std;
+
+SolverServer::Connection::~Connection() {
+    close(Fd);
+}
+
+SolverServer::SolverServer(const ServerOptions& options) : options(options) {}
+
+bool SolverServer::start() {
+    if (!options.SolutionCachePath.empty() && !solutions.open(options.SolutionCachePath)) {
+        cerr << "Cannot open solution cache " << options.SolutionCachePath << endl;
+        return false;
+    }
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (options.SocketPath.size() >= sizeof(addr.sun_path)) {
+        cerr << "Socket path too long: " << options.SocketPath << endl;
+        return false;
+    }
+    strcpy(addr.sun_path, options.SocketPath.c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    // Only a stale socket is removed; any other file at the path is left alone.
+    struct stat st;
+    if (lstat(options.SocketPath.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            cerr << options.SocketPath << " exists and is not a socket" << endl;
+            close(fd);
+            return false;
+        }
+        unlink(options.SocketPath.c_str());
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 64) < 0) {
+        cerr << "Cannot listen on " << options.SocketPath << ": " << strerror(errno) << endl;
+        close(fd);
+        return false;
+    }
+    listenFd.store(fd);
+    int workers = options.Workers > 0 ? options.Workers : max(1u, thread::hardware_concurrency());
+    tableBytes = options.TableBytes / workers;
+    for (int w = 0; w < workers; ++w) {
+        solvers.emplace_back([this]() { solveLoop(); });
+    }
+    return true;
+}
+
+void SolverServer::serve() {
+    while (!stopping.load()) {
+        int fd = accept(listenFd.load(), nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        auto conn = make_shared<Connection>();
+        conn->Fd = fd;
+        lock_guard<mutex> lock(connMutex);
+        connections.erase(remove_if(connections.begin(), connections.end(), [](const weak_ptr<Connection>& c) {
+            return c.expired();
+        }), connections.end());
+        connections.push_back(conn);
+        readers++;
+        thread([this, conn]() { readLoop(conn); }).detach();
+    }
+}
+
+void SolverServer::stop() {
+    stopping.store(true);
+    int fd = listenFd.load();
+    if (fd >= 0) {
+        shutdown(fd, SHUT_RDWR);
+    }
+}
+
+// The connections are shut down first, so the readers return and no new jobs come in. stop has
+// set stopping, which cancels the solves in flight and fails the queued jobs, so the solver
+// threads join without searching any further.
+SolverServer::~SolverServer() {
+    stop();
+    {
+        unique_lock<mutex> lock(connMutex);
+        for (const auto& weak : connections) {
+            if (auto conn = weak.lock()) {
+                shutdown(conn->Fd, SHUT_RDWR);
+            }
+        }
+        connCV.wait(lock, [&]{ return readers == 0; });
+    }
+    {
+        lock_guard<mutex> lock(queueMutex);
+        closing = true;
+    }
+    queueCV.notify_all();
+    for (auto& solver : solvers) {
+        solver.join();
+    }
+    int fd = listenFd.exchange(-1);
+    if (fd >= 0) {
+        close(fd);
+        unlink(options.SocketPath.c_str());
+    }
+}
+
+ServerStats SolverServer::stats() const {
+    return ServerStats{requests.load(), cacheHits.load()};
+}
+
+// readLoop queues every request of one connection. A frame that does not decode closes it.
+void SolverServer::readLoop(shared_ptr<Connection> conn) {
+    string payload;
+    while (readFrame(conn->Fd, payload)) {
+        Job job{conn, PuzzleRequest()};
+        if (!decodeRequest(payload, job.Request)) {
+            break;
+        }
+        requests.fetch_add(1);
+        {
+            lock_guard<mutex> lock(queueMutex);
+            queue.push_back(std::move(job));
+        }
+        queueCV.notify_one();
+    }
+    shutdown(conn->Fd, SHUT_RDWR);
+    conn.reset();
+    lock_guard<mutex> lock(connMutex);
+    readers--;
+    connCV.notify_all();
+}
+
+void SolverServer::solveLoop() {
+    SolveOptions solveOptions;
+    solveOptions.Threads = options.ThreadsPerSolve;
+    solveOptions.TableBytes = tableBytes;
+    SolverContext context(solveOptions);
+    for (;;) {
+        Job job;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            queueCV.wait(lock, [&]{ return closing || !queue.empty(); });
+            if (queue.empty()) {
+                return;
+            }
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+        PuzzleReply reply;
+        try {
+            // After stop the queued jobs fail at once instead of being solved.
+            if (stopping.load()) {
+                reply.Id = job.Request.Id;
+                reply.Status = SolveStatus::Timeout;
+            } else {
+                reply = handle(job.Request, context);
+            }
+        } catch (const exception& e) {
+            cerr << "Exception in solver thread: " << e.what() << endl;
+            reply.Id = job.Request.Id;
+        }
+        lock_guard<mutex> lock(job.Conn->WriteMutex);
+        writeFrame(job.Conn->Fd, encodeReply(reply));
+    }
+}
+
+PuzzleReply SolverServer::handle(const PuzzleRequest& request, SolverContext& context) {
+    SolveOptions solveOptions;
+    solveOptions.Threads = options.ThreadsPerSolve;
+    solveOptions.Engine = request.Engine;
+    solveOptions.Deadline = request.DeadlineMs > 0 ? chrono::milliseconds(request.DeadlineMs) : options.DefaultDeadline;
+    solveOptions.Cache = request.NoCache ? nullptr : &solutions;
+    solveOptions.Stop = &stopping;
+    auto start = chrono::steady_clock::now();
+    SolveResult result = solve(request.puzzle(), solveOptions, context);
+    auto took = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+    if (result.Stats.Cached) {
+        cacheHits.fetch_add(1);
+    }
+
+    PuzzleReply reply;
+    reply.Id = request.Id;
+    reply.Status = result.Status;
+    reply.Cached = result.Stats.Cached;
+    reply.Nodes = result.Stats.Nodes;
+    reply.Micros = static_cast<uint32_t>(took.count());
+    if (result.Status == SolveStatus::Solved) {
+        reply.Filled = result.Filled;
+    }
+    return reply;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "options.h"
+#include "protocol.h"
+#include "solutioncache.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class SolverContext;
+
+struct ServerOptions {
+    std::string SocketPath = "/tmp/heyawake.sock";
+    // Solver threads, each with its own warm SolverContext; zero means one per hardware thread.
+    int Workers = 0;
+    // Search threads of one solve. Small puzzles are spread one per core, so the default is 1.
+    int ThreadsPerSolve = 1;
+    // Dead-state table memory of the whole daemon, split evenly between the solver threads.
+    size_t TableBytes = TranspositionTable::DefaultBytes;
+    // Deadline of the requests that do not set one, zero means none.
+    std::chrono::milliseconds DefaultDeadline{0};
+    // File of the solution cache, empty keeps the cache in memory only.
+    std::string SolutionCachePath;
+};
+
+struct ServerStats {
+    uint64_t Requests = 0;
+    uint64_t CacheHits = 0;
+};
+
+// SolverServer is the solver daemon: it accepts connections on a Unix socket, reads requests
+// (protocol.h) on one thread per connection and queues them for the solver threads. A solver
+// thread takes one queued request at a time and solves it on its warm context, so a slow puzzle
+// never holds others back while a solver thread is free. Solved and unsolvable puzzles are kept
+// in the solution cache.
+class SolverServer {
+    public:
+        explicit SolverServer(const ServerOptions& options);
+        SolverServer(const SolverServer&) = delete;
+        SolverServer& operator=(const SolverServer&) = delete;
+        // The destructor closes every connection and joins the threads.
+        ~SolverServer();
+
+        // start binds the socket and starts the solver threads; false if the socket cannot be bound.
+        bool start();
+        // serve accepts connections until stop is called.
+        void serve();
+        // stop makes serve return. It only shuts the listening socket down, so a signal handler
+        // may call it.
+        void stop();
+        ServerStats stats() const;
+
+    private:
+        struct Connection {
+            int Fd = -1;
+            std::mutex WriteMutex;
+            ~Connection();
+        };
+        struct Job {
+            std::shared_ptr<Connection> Conn;
+            PuzzleRequest Request;
+        };
+
+        void readLoop(std::shared_ptr<Connection> conn);
+        void solveLoop();
+        PuzzleReply handle(const PuzzleRequest& request, SolverContext& context);
+
+        ServerOptions options;
+        // Table size of each solver thread's context, set by start.
+        size_t tableBytes = 0;
+        std::atomic<int> listenFd{-1};
+        std::atomic<bool> stopping{false};
+
+        std::mutex queueMutex;
+        std::condition_variable queueCV;
+        std::deque<Job> queue;
+        bool closing = false;
+        std::vector<std::thread> solvers;
+
+        std::mutex connMutex;
+        std::condition_variable connCV;
+        std::vector<std::weak_ptr<Connection>> connections;
+        int readers = 0;
+
+        SolutionCache solutions;
+
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> cacheHits{0};
+};
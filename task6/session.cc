@@ -0,0 +1,119 @@
+#include "session.h"
+#include "board.h"
+#include "context.h"
+#include "trace.h"
+#include <chrono>
+#include <mutex>
+using namespace std;
+
+SolveSession::SolveSession(SolverContext& context)
+    : Context(context), DeadStates(context.DeadStates), options(context.Options), start(chrono::steady_clock::now()) {
+    Progress.NodeBudget = options.NodeBudget;
+}
+
+SolveSession::~SolveSession() {
+    delete solution.load();
+}
+
+void SolveSession::attach(Board& board) {
+    board.DeadStates = options.DeadStateTable ? &DeadStates : nullptr;
+    board.Progress = &Progress;
+}
+
+void SolveSession::workerStarted() {
+    lock_guard<mutex> lock(resultMutex);
+    active++;
+}
+
+void SolveSession::workerDone() {
+    lock_guard<mutex> lock(resultMutex);
+    active--;
+    resultCV.notify_all();
+}
+
+// The slot is filled before the compare-and-swap, so the release ordering publishes it whole.
+// The mutex is only taken to wake wait(), after the result is already visible.
+bool SolveSession::publish(const Board& board, int worker) {
+    if (solution.load(memory_order_acquire) != nullptr) {
+        return false;
+    }
+    auto slot = make_unique<SolutionSlot>();
+    slot->Worker = worker;
+    slot->Black = board.filledMask();
+    SolutionSlot* expected = nullptr;
+    if (!solution.compare_exchange_strong(expected, slot.get(), memory_order_acq_rel)) {
+        return false;
+    }
+    slot.release();
+    Cancel.store(true);
+    TRACE_INSTANT("solution");
+    {
+        lock_guard<mutex> lock(resultMutex);
+    }
+    resultCV.notify_all();
+    return true;
+}
+
+// StopPoll is how often wait looks at options.Stop.
+constexpr chrono::milliseconds StopPoll{10};
+
+void SolveSession::fail() {
+    failed.store(true);
+    Cancel.store(true);
+    {
+        lock_guard<mutex> lock(resultMutex);
+    }
+    resultCV.notify_all();
+}
+
+bool SolveSession::wait() {
+    bool timedOut = false;
+    {
+        unique_lock<mutex> lock(resultMutex);
+        auto finished = [&]{
+            return solution.load() != nullptr || failed.load() || Progress.BudgetExceeded.load() || active == 0;
+        };
+        if (options.Stop != nullptr) {
+            while (!resultCV.wait_for(lock, StopPoll, finished)) {
+                bool late = options.Deadline.count() > 0 && chrono::steady_clock::now() >= start + options.Deadline;
+                if (late || options.Stop->load()) {
+                    timedOut = true;
+                    break;
+                }
+            }
+        } else if (options.Deadline.count() > 0) {
+            timedOut = !resultCV.wait_until(lock, start + options.Deadline, finished);
+        } else {
+            resultCV.wait(lock, finished);
+        }
+    }
+    Cancel.store(true);
+    TRACE_INSTANT("cancel");
+    return timedOut;
+}
+
+// finish must be called after every worker has been joined. It turns the solution mask into cell
+// indexes on the calling thread.
+SolveResult SolveSession::finish(bool timedOut) {
+    if (const SolutionSlot* slot = solution.load(memory_order_acquire)) {
+        Result.Status = SolveStatus::Solved;
+        Result.Stats.Worker = slot->Worker;
+        Result.Filled.clear();
+        slot->Black.forEach([&](int idx) {
+            Result.Filled.push_back(idx);
+        });
+    } else if (failed.load()) {
+        Result.Status = SolveStatus::Invalid;
+        Result.Filled = Progress.BestFilled;
+    } else if (timedOut || Progress.BudgetExceeded.load()) {
+        Result.Status = SolveStatus::Timeout;
+        Result.Filled = Progress.BestFilled;
+    } else {
+        Result.Status = SolveStatus::Unsat;
+        Result.Filled = Progress.BestFilled;
+    }
+    Result.Stats.Nodes = Progress.Nodes.load();
+    Result.Stats.TableHits = Progress.TableHits.load();
+    Result.Stats.Seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return Result;
+}
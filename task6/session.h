@@ -0,0 +1,61 @@
+#pragma once
+#include "cellmask.h"
+#include "options.h"
+#include "progress.h"
+#include "result.h"
+#include "zobrist.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+class Board;
+class SolverContext;
+
+// SolutionSlot is a published solution: the worker that found it and its black cells.
+struct SolutionSlot {
+    int Worker = 0;
+    CellMask Black;
+};
+
+// SolveSession is the state shared by the threads of one solve: cancellation, node accounting
+// and the published result. The dead-state table and the threads belong to the Context.
+class SolveSession {
+    public:
+        explicit SolveSession(SolverContext& context);
+        ~SolveSession();
+
+        SolverContext& Context;
+        std::atomic<bool> Cancel{false};
+        TranspositionTable& DeadStates;
+        SearchProgress Progress;
+        // Result.Stats may be filled by the engine; status and cells are set by finish.
+        SolveResult Result;
+
+        // attach points the board at the shared table and node accounting.
+        void attach(Board& board);
+        void workerStarted();
+        void workerDone();
+        // publish offers board as the solution with one compare-and-swap on the solution slot. The
+        // first worker wins and cancels the rest; publish returns whether this call won. worker is
+        // the index of the publishing worker, from 0.
+        bool publish(const Board& board, int worker);
+        // fail marks the solve as broken by an error in one of its threads and cancels it; without
+        // a solution it then finishes as Invalid, so the result is never taken for a proof.
+        void fail();
+        // wait blocks until a solution is published, the node budget is spent, every worker is done
+        // or the deadline passes, then cancels the search. Returns true if the deadline passed or
+        // the options' Stop flag was set.
+        bool wait();
+        SolveResult finish(bool timedOut);
+
+    private:
+        SolveOptions options;
+        std::chrono::steady_clock::time_point start;
+        std::mutex resultMutex;
+        std::condition_variable resultCV;
+        int active = 0;
+        std::atomic<SolutionSlot*> solution{nullptr};
+        std::atomic<bool> failed{false};
+};
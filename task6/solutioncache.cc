@@ -0,0 +1,255 @@
+#include "solutioncache.h"
+#include "board.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+using namespace std;
+
+namespace {
+
+// File layout: the 8-byte magic, then records of
+//   u64 key hi, u64 key lo, u32 status, u32 cell count, ceil(cells / 64) u64 solution words
+// in host byte order. Every field is 8-byte aligned in the mapping.
+constexpr char Magic[8] = {'H', 'W', 'S', 'C', 'A', 'C', 'H', '1'};
+constexpr size_t RecordHeader = 24;
+
+size_t wordCount(uint32_t cells) {
+    return (cells + 63) / 64;
+}
+
+void put(string& out, uint64_t value, int bytes) {
+    for (int b = 0; b < bytes; ++b) {
+        out.push_back(static_cast<char>(value >> (8 * b)));
+    }
+}
+
+// cellOrder lists the board cell indexes in row-major order.
+vector<int> cellOrder(const Board& board) {
+    vector<int> order(board.Cells.size());
+    for (size_t k = 0; k < order.size(); ++k) {
+        order[k] = static_cast<int>(k);
+    }
+    sort(order.begin(), order.end(), [&](int a, int b) {
+        const Cell& x = board.Cells[a];
+        const Cell& y = board.Cells[b];
+        return x.i != y.i ? x.i < y.i : x.j < y.j;
+    });
+    return order;
+}
+
+uint64_t finish(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+}
+
+string canonicalPuzzle(const Board& board) {
+    int minI = INT_MAX, minJ = INT_MAX, maxI = INT_MIN, maxJ = INT_MIN;
+    for (const auto& cell : board.Cells) {
+        minI = min(minI, cell.i);
+        minJ = min(minJ, cell.j);
+        maxI = max(maxI, cell.i);
+        maxJ = max(maxJ, cell.j);
+    }
+    if (board.Cells.empty()) {
+        return string();
+    }
+    int rows = maxI - minI + 1;
+    int cols = maxJ - minJ + 1;
+    // room[p] is the sector of grid position p, -1 where the board has no cell.
+    vector<int> room(size_t(rows) * cols, -1);
+    for (size_t s = 0; s < board.Sectors.size(); ++s) {
+        board.Sectors[s].forEachCell([&](const Cell& cell) {
+            room[size_t(cell.i - minI) * cols + (cell.j - minJ)] = static_cast<int>(s);
+        });
+    }
+    vector<int> label(board.Sectors.size(), -1);
+    vector<int> numbers;
+    string out;
+    put(out, rows, 2);
+    put(out, cols, 2);
+    vector<bool> present(room.size(), false);
+    for (const auto& cell : board.Cells) {
+        present[size_t(cell.i - minI) * cols + (cell.j - minJ)] = true;
+    }
+    for (size_t p = 0; p < room.size(); ++p) {
+        int s = present[p] ? room[p] : -1;
+        if (s >= 0 && label[s] < 0) {
+            label[s] = static_cast<int>(numbers.size());
+            const Sector& sector = board.Sectors[s];
+            numbers.push_back(sector.Number != nullptr ? *sector.Number : -1);
+        }
+        put(out, s >= 0 ? label[s] + 1 : 0, 2);
+    }
+    put(out, numbers.size(), 2);
+    for (int number : numbers) {
+        put(out, static_cast<uint16_t>(number), 2);
+    }
+    return out;
+}
+
+// puzzleKey runs two differently seeded byte hashes over the encoding and mixes each down.
+PuzzleKey puzzleKey(const string& canonical) {
+    uint64_t a = 0xCBF29CE484222325ULL;
+    uint64_t b = 0x9E3779B97F4A7C15ULL ^ canonical.size();
+    for (unsigned char c : canonical) {
+        a = (a ^ c) * 0x100000001B3ULL;
+        b = (b + c) * 0xFF51AFD7ED558CCDULL;
+        b ^= b >> 29;
+    }
+    return PuzzleKey{finish(a ^ (b << 1)), finish(b ^ 0xC4CEB9FE1A85EC53ULL)};
+}
+
+SolutionCache::~SolutionCache() {
+    closeFile();
+}
+
+// Several processes may share the file: it is opened with O_APPEND, and open and every append
+// hold an exclusive flock, so a torn tail is only cut off while no other process is writing.
+bool SolutionCache::open(const string& path) {
+    lock_guard<mutex> lock(cacheMutex);
+    if (fd >= 0) {
+        return false;
+    }
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    if (flock(fd, LOCK_EX) < 0) {
+        closeFile();
+        return false;
+    }
+    bool ok = indexFile();
+    flock(fd, LOCK_UN);
+    if (!ok) {
+        entries.clear();
+        closeFile();
+    }
+    return ok;
+}
+
+// indexFile writes the magic into an empty file, or maps the file and indexes its records.
+bool SolutionCache::indexFile() {
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    if (size < sizeof(Magic)) {
+        return ftruncate(fd, 0) == 0 && write(fd, Magic, sizeof(Magic)) == static_cast<ssize_t>(sizeof(Magic));
+    }
+    mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        mapped = nullptr;
+        return false;
+    }
+    mappedBytes = size;
+    const char* data = static_cast<const char*>(mapped);
+    if (memcmp(data, Magic, sizeof(Magic)) != 0) {
+        return false;
+    }
+    size_t pos = sizeof(Magic);
+    while (pos + RecordHeader <= size) {
+        const uint64_t* header = reinterpret_cast<const uint64_t*>(data + pos);
+        uint32_t status = static_cast<uint32_t>(header[2]);
+        uint32_t cells = static_cast<uint32_t>(header[2] >> 32);
+        size_t bytes = RecordHeader + wordCount(cells) * sizeof(uint64_t);
+        if (pos + bytes > size) {
+            break;
+        }
+        Entry& entry = entries[PuzzleKey{header[0], header[1]}];
+        entry.Status = status == static_cast<uint32_t>(SolveStatus::Solved) ? SolveStatus::Solved : SolveStatus::Unsat;
+        entry.Cells = cells;
+        entry.Words = header + 3;
+        entry.Owned.clear();
+        pos += bytes;
+    }
+    return pos == size || ftruncate(fd, pos) == 0;
+}
+
+void SolutionCache::closeFile() {
+    if (mapped != nullptr) {
+        munmap(mapped, mappedBytes);
+        mapped = nullptr;
+        mappedBytes = 0;
+    }
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+bool SolutionCache::lookup(const Board& board, SolveResult& result) {
+    PuzzleKey key = puzzleKey(canonicalPuzzle(board));
+    lock_guard<mutex> lock(cacheMutex);
+    auto it = entries.find(key);
+    if (it == entries.end() || it->second.Cells != board.Cells.size()) {
+        return false;
+    }
+    const Entry& entry = it->second;
+    result.Status = entry.Status;
+    result.Filled.clear();
+    if (entry.Status == SolveStatus::Solved) {
+        vector<int> order = cellOrder(board);
+        for (size_t k = 0; k < order.size(); ++k) {
+            if (entry.Words[k / 64] >> (k % 64) & 1) {
+                result.Filled.push_back(order[k]);
+            }
+        }
+    }
+    return true;
+}
+
+void SolutionCache::record(const Board& board, const SolveResult& result) {
+    if (result.Status != SolveStatus::Solved && result.Status != SolveStatus::Unsat) {
+        return;
+    }
+    PuzzleKey key = puzzleKey(canonicalPuzzle(board));
+    uint32_t cells = static_cast<uint32_t>(board.Cells.size());
+    vector<uint64_t> words(wordCount(cells));
+    if (result.Status == SolveStatus::Solved) {
+        vector<int> order = cellOrder(board);
+        vector<int> position(order.size());
+        for (size_t k = 0; k < order.size(); ++k) {
+            position[order[k]] = static_cast<int>(k);
+        }
+        for (int idx : result.Filled) {
+            words[position[idx] / 64] |= uint64_t(1) << (position[idx] % 64);
+        }
+    }
+    lock_guard<mutex> lock(cacheMutex);
+    if (entries.count(key) != 0) {
+        return;
+    }
+    Entry& entry = entries[key];
+    entry.Status = result.Status;
+    entry.Cells = cells;
+    entry.Owned = std::move(words);
+    entry.Words = entry.Owned.data();
+    if (fd >= 0) {
+        vector<uint64_t> record{key.Hi, key.Lo, static_cast<uint32_t>(result.Status) | uint64_t(cells) << 32};
+        record.insert(record.end(), entry.Owned.begin(), entry.Owned.end());
+        // One write per record at the end of the file; a torn write is cut off by the next open.
+        // A failed write stops the appends, the records already mapped stay readable.
+        ssize_t bytes = static_cast<ssize_t>(record.size() * sizeof(uint64_t));
+        bool written = flock(fd, LOCK_EX) == 0;
+        written = written && write(fd, record.data(), bytes) == bytes;
+        flock(fd, LOCK_UN);
+        if (!written) {
+            close(fd);
+            fd = -1;
+        }
+    }
+}
+
+size_t SolutionCache::size() const {
+    lock_guard<mutex> lock(cacheMutex);
+    return entries.size();
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "result.h"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Board;
+
+// PuzzleKey is the 128-bit hash of a canonical puzzle encoding.
+struct PuzzleKey {
+    uint64_t Hi = 0;
+    uint64_t Lo = 0;
+
+    bool operator==(const PuzzleKey& other) const {
+        return Hi == other.Hi && Lo == other.Lo;
+    }
+};
+
+// canonicalPuzzle encodes the room grid and the numbers of board so that equal puzzles encode
+// equally: the grid is cut to the bounding box of the cells and the rooms are renamed in the
+// order they first appear row by row, so neither the room order nor the position of the board
+// matters.
+std::string canonicalPuzzle(const Board& board);
+PuzzleKey puzzleKey(const std::string& canonical);
+
+// SolutionCache maps puzzle keys to solutions (a bitmask over the cells in row-major order) and
+// to proven-unsolvable results. open maps an append-only file once and indexes it in place; new
+// results are appended to the file and kept in memory. Without open the cache lives in memory
+// only. All methods may be called from several threads.
+class SolutionCache {
+    public:
+        SolutionCache() = default;
+        SolutionCache(const SolutionCache&) = delete;
+        SolutionCache& operator=(const SolutionCache&) = delete;
+        ~SolutionCache();
+
+        // open maps path, creating it if needed. A torn record at the end is cut off. Several
+        // processes may open the same file; each sees the records written before its open.
+        bool open(const std::string& path);
+        // lookup fills Status and Filled of result if board is in the cache.
+        bool lookup(const Board& board, SolveResult& result);
+        // record stores a Solved or Unsat result of board; other results are ignored.
+        void record(const Board& board, const SolveResult& result);
+        size_t size() const;
+
+    private:
+        struct KeyHash {
+            size_t operator()(const PuzzleKey& key) const {
+                return static_cast<size_t>(key.Lo);
+            }
+        };
+        // Entry points at its words in the mapping, or at Owned for results added since open.
+        struct Entry {
+            SolveStatus Status = SolveStatus::Unsat;
+            uint32_t Cells = 0;
+            const uint64_t* Words = nullptr;
+            std::vector<uint64_t> Owned;
+        };
+
+        // indexFile and closeFile are called with cacheMutex held.
+        bool indexFile();
+        void closeFile();
+
+        mutable std::mutex cacheMutex;
+        std::unordered_map<PuzzleKey, Entry, KeyHash> entries;
+        int fd = -1;
+        void* mapped = nullptr;
+        size_t mappedBytes = 0;
+};
@@ -0,0 +1,62 @@
+#include "board.h"
+#include "client.h"
+#include "initalBoards.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// solveclient sends built-in boards to the daemon and prints the answers.
+//
+//   client.out [--socket PATH] [--engine NAME] [--deadline MS] [BOARD...]
+//
+// Boards are numbered from 1; without numbers every built-in board is sent.
+int main(int argc, char** argv) {
+    string socketPath = "/tmp/heyawake.sock";
+    string engine;
+    uint32_t deadline = 0;
+    vector<size_t> boards;
+    for (int a = 1; a < argc; ++a) {
+        string arg = argv[a];
+        if (arg == "--socket" && a + 1 < argc) {
+            socketPath = argv[++a];
+        } else if (arg == "--engine" && a + 1 < argc) {
+            engine = argv[++a];
+        } else if (arg == "--deadline" && a + 1 < argc) {
+            deadline = atoi(argv[++a]);
+        } else {
+            boards.push_back(atoi(arg.c_str()));
+        }
+    }
+    if (boards.empty()) {
+        for (size_t i = 1; i <= builtinPuzzleCount(); ++i) {
+            boards.push_back(i);
+        }
+    }
+    SolverClient client;
+    if (!client.connect(socketPath)) {
+        cerr << "Cannot connect to " << socketPath << endl;
+        return 1;
+    }
+    const char* statuses[] = {"solved", "unsat", "timeout", "invalid"};
+    for (size_t number : boards) {
+        if (number < 1 || number > builtinPuzzleCount()) {
+            cerr << "No board " << number << endl;
+            continue;
+        }
+        const Puzzle& puzzle = builtinPuzzle(number - 1);
+        PuzzleReply reply;
+        if (!client.solve(makeRequest(puzzle, static_cast<uint32_t>(number), engine, deadline), reply)) {
+            cerr << "Connection lost" << endl;
+            return 1;
+        }
+        cout << "Board " << number << ": " << statuses[static_cast<int>(reply.Status)]
+             << (reply.Cached ? " (cached)" : "") << ", " << reply.Micros << " us, " << reply.Nodes << " nodes" << endl;
+        Board board{vector<Cell>(), vector<Sector>()};
+        if (reply.Status == SolveStatus::Solved && loadPuzzle(puzzle, board)) {
+            board.setFilled(reply.Filled);
+            cout << board.display();
+        }
+    }
+}
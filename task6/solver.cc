@@ -0,0 +1,41 @@
+#include "solver.h"
+using namespace std;
+
+namespace {
+
+bool canBlackDynamic(const Bitboard& present, const Bitboard& black, int i, int j) {
+    if ((j > 0 && black.test(i, j - 1)) || (j + 1 < Bitboard::MaxCols && black.test(i, j + 1))) {
+        return false;
+    }
+    if ((i > 0 && black.test(i - 1, j)) || (i + 1 < Bitboard::MaxRows && black.test(i + 1, j))) {
+        return false;
+    }
+    if (!present.test(i, j) || black.test(i, j)) {
+        return true;
+    }
+    Bitboard white = present;
+    for (int r = 0; r < white.Rows; ++r) {
+        white.Bits[r] &= ~black.Bits[r];
+    }
+    white.reset(i, j);
+    return whiteConnected(white);
+}
+
+const BoardKernels dynamicKernels{0, 0, whiteConnected, longRunRow, longRunCol, canBlackDynamic};
+
+}
+
+// boardKernels picks the smallest specialization the board fits in; the common puzzle sizes are
+// 10x10, 12x12 and 17x17.
+const BoardKernels& boardKernels(int rows, int cols) {
+    if (rows <= 10 && cols <= 10) {
+        return Solver<10, 10>::kernels();
+    }
+    if (rows <= 12 && cols <= 12) {
+        return Solver<12, 12>::kernels();
+    }
+    if (rows <= 17 && cols <= 17) {
+        return Solver<17, 17>::kernels();
+    }
+    return dynamicKernels;
+}
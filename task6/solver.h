@@ -0,0 +1,172 @@
+#pragma once
+#include "bitboard.h"
+#include <array>
+#include <cstdint>
+
+// BoardKernels are the bitboard checks the search runs on every node. boardKernels picks them
+// once per board in setNumbers: a Solver specialization when the board fits one, otherwise the
+// dynamic kernels of bitboard.h.
+struct BoardKernels {
+    // Rows and Cols of the specialization, 0 for the dynamic kernels.
+    int Rows = 0;
+    int Cols = 0;
+    bool (*Connected)(const Bitboard& white) = nullptr;
+    int (*LongRunRow)(const Bitboard& white, const Bitboard& borders) = nullptr;
+    int (*LongRunCol)(const Bitboard& white, const Bitboard& borders) = nullptr;
+    // CanBlack reports whether cell (i, j) can turn black: no black neighbor, and if it is white,
+    // the other white cells stay connected.
+    bool (*CanBlack)(const Bitboard& present, const Bitboard& black, int i, int j) = nullptr;
+};
+
+const BoardKernels& boardKernels(int rows, int cols);
+
+// Solver holds the kernels for boards of at most Rows x Cols cells. The board lives in a local
+// std::array of Rows words, the fills take only as many steps as Cols needs and the row loops
+// are unrolled at compile time, so the whole state stays in registers.
+template <int Rows, int Cols>
+struct Solver {
+    static_assert(Rows > 0 && Rows <= Bitboard::MaxRows, "Rows out of range");
+    static_assert(Cols > 0 && Cols <= Bitboard::MaxCols, "Cols out of range");
+    using Words = std::array<uint64_t, Rows>;
+
+    static constexpr uint64_t ColMask = Cols == 64 ? ~uint64_t(0) : (uint64_t(1) << Cols) - 1;
+
+    // Neighbors[j] is the mask of the cells left and right of column j.
+    static constexpr std::array<uint64_t, Cols> Neighbors = [] {
+        std::array<uint64_t, Cols> res{};
+        for (int j = 0; j < Cols; ++j) {
+            res[j] = ((uint64_t(1) << j) << 1 | (uint64_t(1) << j) >> 1) & ColMask;
+        }
+        return res;
+    }();
+
+    static Words load(const Bitboard& board) {
+        Words res;
+#pragma GCC unroll 64
+        for (int i = 0; i < Rows; ++i) {
+            res[i] = board.Bits[i];
+        }
+        return res;
+    }
+
+    static uint64_t fillUp(uint64_t x, uint64_t m) {
+        uint64_t pro = m;
+#pragma GCC unroll 8
+        for (int s = 1; s < Cols; s *= 2) {
+            x |= pro & (x << s);
+            pro &= pro << s;
+        }
+        return x;
+    }
+
+    static uint64_t fillDown(uint64_t x, uint64_t m) {
+        uint64_t pro = m;
+#pragma GCC unroll 8
+        for (int s = 1; s < Cols; s *= 2) {
+            x |= pro & (x >> s);
+            pro &= pro >> s;
+        }
+        return x;
+    }
+
+    // step fills row i from itself and its neighbor rows and returns the bits that changed.
+    static uint64_t step(Words& reached, const Words& white, int i) {
+        uint64_t from = reached[i] | (i > 0 ? reached[i - 1] : 0) | (i + 1 < Rows ? reached[i + 1] : 0);
+        from &= white[i];
+        uint64_t next = fillUp(from, white[i]) | fillDown(from, white[i]);
+        uint64_t changed = next ^ reached[i];
+        reached[i] = next;
+        return changed;
+    }
+
+    static bool connected(const Words& white) {
+        Words reached{};
+        int first = 0;
+        while (first < Rows && white[first] == 0) {
+            first++;
+        }
+        if (first == Rows) {
+            return true;
+        }
+        reached[first] = white[first] & (~white[first] + 1);
+        uint64_t changed = 1;
+        while (changed != 0) {
+            changed = 0;
+#pragma GCC unroll 16
+            for (int i = 0; i < Rows; ++i) {
+                changed |= step(reached, white, i);
+            }
+#pragma GCC unroll 16
+            for (int i = Rows - 1; i >= 0; --i) {
+                changed |= step(reached, white, i);
+            }
+        }
+        uint64_t diff = 0;
+#pragma GCC unroll 64
+        for (int i = 0; i < Rows; ++i) {
+            diff |= reached[i] ^ white[i];
+        }
+        return diff == 0;
+    }
+
+    static bool connected(const Bitboard& white) {
+        return connected(load(white));
+    }
+
+    static int longRunRow(const Bitboard& whiteBoard, const Bitboard& bordersBoard) {
+        Words white = load(whiteBoard);
+        Words borders = load(bordersBoard);
+        uint64_t rows = 0;
+#pragma GCC unroll 64
+        for (int i = 0; i < Rows; ++i) {
+            uint64_t cross = borders[i] & white[i] & (white[i] << 1);
+            if ((cross & (cross - 1)) != 0 && (cross & fillUp(white[i] & (cross << 1), white[i])) != 0) {
+                rows |= uint64_t(1) << i;
+            }
+        }
+        return rows != 0 ? __builtin_ctzll(rows) : -1;
+    }
+
+    static int longRunCol(const Bitboard& whiteBoard, const Bitboard& bordersBoard) {
+        Words white = load(whiteBoard);
+        Words borders = load(bordersBoard);
+        uint64_t reach = 0, hits = 0;
+#pragma GCC unroll 64
+        for (int i = 1; i < Rows; ++i) {
+            uint64_t cross = borders[i] & white[i] & white[i - 1];
+            reach &= white[i];
+            hits |= reach & cross;
+            reach |= cross;
+        }
+        return hits != 0 ? __builtin_ctzll(hits) : -1;
+    }
+
+    static bool canBlack(const Bitboard& presentBoard, const Bitboard& blackBoard, int i, int j) {
+        uint64_t bit = uint64_t(1) << j;
+        uint64_t around = blackBoard.Bits[i] & Neighbors[j];
+        if (i > 0) {
+            around |= blackBoard.Bits[i - 1] & bit;
+        }
+        if (i + 1 < Rows) {
+            around |= blackBoard.Bits[i + 1] & bit;
+        }
+        if (around != 0) {
+            return false;
+        }
+        if (!(presentBoard.Bits[i] & bit) || (blackBoard.Bits[i] & bit)) {
+            return true;
+        }
+        Words white;
+#pragma GCC unroll 64
+        for (int r = 0; r < Rows; ++r) {
+            white[r] = presentBoard.Bits[r] & ~blackBoard.Bits[r];
+        }
+        white[i] &= ~bit;
+        return connected(white);
+    }
+
+    static const BoardKernels& kernels() {
+        static const BoardKernels res{Rows, Cols, connected, longRunRow, longRunCol, canBlack};
+        return res;
+    }
+};
@@ -0,0 +1,232 @@
+#include "stream.h"
+#include "context.h"
+#include "heyawake.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+using namespace std;
+
+namespace {
+
+const char* statusName(SolveStatus status) {
+    switch (status) {
+    case SolveStatus::Solved:
+        return "solved";
+    case SolveStatus::Unsat:
+        return "unsat";
+    case SolveStatus::Timeout:
+        return "timeout";
+    case SolveStatus::Invalid:
+        break;
+    }
+    return "invalid";
+}
+
+// parseInt reads a whole non-negative decimal number; false on anything else.
+bool parseInt(const string& text, int& value) {
+    if (text.empty() || text.size() > 6 || !all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return false;
+    }
+    value = stoi(text);
+    return true;
+}
+
+struct Line {
+    uint64_t Id = 0;
+    string Text;
+};
+
+}
+
+Puzzle LinePuzzle::puzzle() const {
+    return Puzzle{Rows, Cols, Rooms, Numbers.data(), Numbers.size()};
+}
+
+bool parsePuzzleLine(const string& line, LinePuzzle& puzzle) {
+    istringstream in(line);
+    string size, numbers, rest;
+    if (!(in >> size >> puzzle.Rooms >> numbers) || (in >> rest)) {
+        return false;
+    }
+    size_t x = size.find('x');
+    if (x == string::npos || !parseInt(size.substr(0, x), puzzle.Rows) || !parseInt(size.substr(x + 1), puzzle.Cols)) {
+        return false;
+    }
+    puzzle.Numbers.clear();
+    size_t start = 0;
+    for (;;) {
+        size_t comma = numbers.find(',', start);
+        string field = numbers.substr(start, comma == string::npos ? string::npos : comma - start);
+        int number = -1;
+        if (field != "-" && !parseInt(field, number)) {
+            return false;
+        }
+        puzzle.Numbers.push_back(number);
+        if (comma == string::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+    return puzzle.Rooms.size() == size_t(puzzle.Rows) * puzzle.Cols;
+}
+
+string formatPuzzleLine(const Puzzle& puzzle) {
+    string res = to_string(puzzle.Rows) + "x" + to_string(puzzle.Cols) + " " + string(puzzle.Rooms) + " ";
+    for (size_t r = 0; r < puzzle.RoomCount; ++r) {
+        if (r > 0) {
+            res += ",";
+        }
+        res += puzzle.Numbers[r] >= 0 ? to_string(puzzle.Numbers[r]) : "-";
+    }
+    return res;
+}
+
+// The cells of Filled are indexes into the board cells, which loadPuzzle lists row by row
+// without the '.' positions.
+string formatResultLine(const Puzzle& puzzle, const SolveResult& result) {
+    string res = statusName(result.Status);
+    if (result.Status != SolveStatus::Solved) {
+        return res;
+    }
+    string grid(puzzle.Rooms);
+    vector<size_t> positions;
+    for (size_t p = 0; p < grid.size(); ++p) {
+        if (grid[p] != '.') {
+            grid[p] = 'o';
+            positions.push_back(p);
+        }
+    }
+    for (int cell : result.Filled) {
+        if (cell >= 0 && size_t(cell) < positions.size()) {
+            grid[positions[cell]] = 'x';
+        }
+    }
+    return res + " " + grid;
+}
+
+StreamStats runStream(istream& in, ostream& out, const StreamOptions& options) {
+    mutex streamMutex;
+    // workCV wakes the solvers for new lines, readyCV the writer for results, spaceCV the reader
+    // when the window has room again.
+    condition_variable workCV, readyCV, spaceCV;
+    deque<Line> pending;
+    // ready holds the finished result lines by ID until the writer takes them.
+    map<uint64_t, string> ready;
+    uint64_t read = 0;
+    uint64_t written = 0;
+    bool eof = false;
+    StreamStats stats;
+    size_t window = max<size_t>(1, options.Window);
+
+    thread reader([&]() {
+        string text;
+        for (;;) {
+            {
+                unique_lock<mutex> lock(streamMutex);
+                spaceCV.wait(lock, [&]{ return read - written < window; });
+            }
+            if (!getline(in, text)) {
+                break;
+            }
+            if (!text.empty() && text.back() == '\r') {
+                text.pop_back();
+            }
+            lock_guard<mutex> lock(streamMutex);
+            pending.push_back(Line{++read, std::move(text)});
+            workCV.notify_one();
+        }
+        lock_guard<mutex> lock(streamMutex);
+        eof = true;
+        workCV.notify_all();
+        readyCV.notify_all();
+    });
+
+    SolveOptions solveOptions = options.Solve;
+    solveOptions.Threads = max(1, options.ThreadsPerSolve);
+    auto solveLoop = [&]() {
+        SolverContext context(solveOptions);
+        for (;;) {
+            Line line;
+            {
+                unique_lock<mutex> lock(streamMutex);
+                workCV.wait(lock, [&]{ return eof || !pending.empty(); });
+                if (pending.empty()) {
+                    return;
+                }
+                line = std::move(pending.front());
+                pending.pop_front();
+            }
+            LinePuzzle puzzle;
+            SolveResult result;
+            result.Status = SolveStatus::Invalid;
+            try {
+                if (parsePuzzleLine(line.Text, puzzle)) {
+                    result = solve(puzzle.puzzle(), solveOptions, context);
+                }
+            } catch (const exception& e) {
+                cerr << "Exception in stream solver thread: " << e.what() << endl;
+                result.Status = SolveStatus::Invalid;
+            }
+            string text = formatResultLine(puzzle.puzzle(), result);
+            if (options.Unordered) {
+                text = to_string(line.Id) + " " + text;
+            }
+            lock_guard<mutex> lock(streamMutex);
+            stats.Solved += result.Status == SolveStatus::Solved;
+            stats.Invalid += result.Status == SolveStatus::Invalid;
+            ready.emplace(line.Id, std::move(text));
+            readyCV.notify_one();
+        }
+    };
+    int workers = options.Workers > 0 ? options.Workers : max(1u, thread::hardware_concurrency());
+    vector<thread> solvers;
+    for (int w = 0; w < workers; ++w) {
+        solvers.emplace_back(solveLoop);
+    }
+
+    // The writer takes every result that may go out now: in order, the run that starts at the
+    // next ID; unordered, all of them.
+    vector<string> batch;
+    for (;;) {
+        {
+            unique_lock<mutex> lock(streamMutex);
+            auto next = [&]{
+                return options.Unordered ? !ready.empty() : ready.count(written + 1) > 0;
+            };
+            readyCV.wait(lock, [&]{ return next() || (eof && written == read); });
+            if (!next()) {
+                break;
+            }
+            if (options.Unordered) {
+                for (auto& entry : ready) {
+                    batch.push_back(std::move(entry.second));
+                }
+                ready.clear();
+            } else {
+                for (auto it = ready.begin(); it != ready.end() && it->first == written + 1 + batch.size(); it = ready.erase(it)) {
+                    batch.push_back(std::move(it->second));
+                }
+            }
+        }
+        for (const auto& text : batch) {
+            out << text << '\n';
+        }
+        out.flush();
+        lock_guard<mutex> lock(streamMutex);
+        written += batch.size();
+        batch.clear();
+        spaceCV.notify_one();
+    }
+
+    reader.join();
+    for (auto& solver : solvers) {
+        solver.join();
+    }
+    stats.Lines = read;
+    return stats;
+}
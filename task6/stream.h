@@ -0,0 +1,61 @@
+#pragma once
+#include "options.h"
+#include "puzzle.h"
+#include "result.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// The line format of the streaming mode, one puzzle or result per line.
+//
+// Puzzle line:  ROWSxCOLS ROOMS NUMBERS
+//   ROOMS is the room grid of Puzzle, row by row; NUMBERS are the room numbers separated by
+//   commas, '-' for a room without a number. "3x3 001001222 2,-,1" is a 3x3 board of 3 rooms.
+// Result line:  [ID] STATUS [GRID]
+//   STATUS is solved, unsat, timeout or invalid. GRID follows a solved status: the ROOMS grid
+//   with 'x' for black cells, 'o' for white cells and '.' where the board has no cell. ID is the
+//   line number of the puzzle, from 1, and is only written in unordered mode.
+
+// LinePuzzle owns the data that Puzzle only points to.
+struct LinePuzzle {
+    int Rows = 0;
+    int Cols = 0;
+    std::string Rooms;
+    std::vector<int> Numbers;
+
+    Puzzle puzzle() const;
+};
+
+// parsePuzzleLine reads a puzzle line; false if it does not follow the format.
+bool parsePuzzleLine(const std::string& line, LinePuzzle& puzzle);
+std::string formatPuzzleLine(const Puzzle& puzzle);
+// formatResultLine writes the result line of result, without the ID and the newline.
+std::string formatResultLine(const Puzzle& puzzle, const SolveResult& result);
+
+struct StreamOptions {
+    // Search options of every puzzle; Deadline is per puzzle.
+    SolveOptions Solve;
+    // Solver threads, each with its own context; zero means one per hardware thread.
+    int Workers = 0;
+    // Search threads of one solve, which replace Solve.Threads. The workers already spread the
+    // puzzles over the cores, so the default is 1.
+    int ThreadsPerSolve = 1;
+    // Unordered writes every result as soon as it is ready, with the ID of its line.
+    bool Unordered = false;
+    // Most lines read ahead of the oldest unwritten result, which bounds the reorder buffer.
+    size_t Window = 256;
+};
+
+struct StreamStats {
+    uint64_t Lines = 0;
+    uint64_t Solved = 0;
+    uint64_t Invalid = 0;
+};
+
+// runStream solves every puzzle line of in and writes one result line per puzzle line to out.
+// Reading, solving and writing overlap: a reader thread parses lines, Workers threads solve
+// them and the calling thread writes the results, in input order through a reorder buffer
+// unless Unordered is set. out is flushed after every run of ready results.
+StreamStats runStream(std::istream& in, std::ostream& out, const StreamOptions& options);
@@ -0,0 +1,237 @@
+#include "board.h"
+#include "combination.h"
+#include "session.h"
+#include "trace.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+using namespace std;
+
+namespace {
+
+// PrefixTask is a subtree of the room combination tree: State already holds the options chosen
+// for the groups before Level, and the task owns options [Next, End) of groups[Level]. A task
+// with Fill set is instead a part of a leaf's fill search, handed off by Board::search.
+struct PrefixTask {
+    Board State{vector<Cell>(), vector<Sector>()};
+    int Level = 0;
+    size_t Next = 0;
+    size_t End = 0;
+    CellMask Blocked;
+    bool Fill = false;
+    vector<int> Candidates;
+    bool CheckSectors = false;
+};
+
+// Frame is one level of a worker's walk; Applied are the cells of the option currently on the board.
+// Blocked holds the cells of the prefix above this level and their neighbors.
+struct Frame {
+    int Level = 0;
+    size_t Next = 0;
+    size_t End = 0;
+    CellMask Blocked;
+    vector<int> Applied;
+};
+
+}
+
+// solvePrefixTree lets the workers walk the room combination tree themselves. A prefix is applied
+// once to the worker's board and shared by all leaves below it; the remaining siblings of the
+// shallowest level are copied into a new task only when some worker is idle.
+SolveResult Board::solvePrefixTree(const SolveOptions& options, SolveSession& session) {
+    int threads = session.Result.Stats.Threads;
+    atomic<bool>& cancel = session.Cancel;
+    vector<vector<vector<Cell>>> groups;
+    vector<vector<OptionMask>> masks;
+    int levels = 0;
+
+    mutex taskMutex;
+    condition_variable taskCV;
+    deque<PrefixTask> tasks;
+    bool rootReady = false;
+    int idle = 0;
+    atomic<int> idleWorkers{0};
+    atomic<int> queuedTasks{0};
+    atomic<int> splits{0};
+    atomic<int> leaves{0};
+
+    auto pushTask = [&](PrefixTask task) {
+        lock_guard<mutex> lock(taskMutex);
+        tasks.push_back(std::move(task));
+        queuedTasks.fetch_add(1);
+        taskCV.notify_one();
+    };
+    // A leaf search that runs long gives its open nodes to idle workers through fillSplits.
+    SplitHook fillSplits{&idleWorkers, &queuedTasks, [&](SearchTask&& sub) {
+        PrefixTask task{std::move(sub.State)};
+        task.Fill = true;
+        task.Candidates = std::move(sub.Candidates);
+        task.CheckSectors = sub.CheckSectors;
+        splits.fetch_add(1);
+        pushTask(std::move(task));
+    }};
+
+    // split hands the upper half of the remaining siblings of the shallowest open frame to an idle worker.
+    auto split = [&](pmr::vector<Frame>& stack, size_t depth, const Board& board) {
+        for (size_t f = 0; f < depth; ++f) {
+            Frame& frame = stack[f];
+            if (frame.Level >= levels || frame.Next >= frame.End) {
+                continue;
+            }
+            size_t mid = frame.Next + (frame.End - frame.Next) / 2;
+            PrefixTask task{board, frame.Level, mid, frame.End, frame.Blocked};
+            for (size_t g = depth; g-- > f;) {
+                vector<int> applied = stack[g].Applied;
+                task.State.undoOption(applied);
+            }
+            frame.End = mid;
+            splits.fetch_add(1);
+            pushTask(std::move(task));
+            return;
+        }
+    };
+
+    // runTask walks one task on the worker's frame stack. Frames above depth are kept with their
+    // Applied buffers, so a warm worker walks the tree without allocating.
+    auto runTask = [&](PrefixTask& task, pmr::vector<Frame>& stack, ScratchArena* arena, int worker) {
+        TRACE_SPAN(task.Fill ? "fill task" : "prefix task");
+        Board& board = task.State;
+        board.Scratch = arena;
+        board.Splits = &fillSplits;
+        if (task.Fill) {
+            if (board.resume(cancel, task.Candidates, task.CheckSectors) && board.valid()) {
+                session.publish(board, worker);
+            }
+            return;
+        }
+        size_t depth = 0;
+        auto push = [&](int level, size_t next, size_t end, const CellMask& blocked) {
+            if (depth == stack.size()) {
+                stack.emplace_back();
+            }
+            Frame& frame = stack[depth++];
+            frame.Level = level;
+            frame.Next = next;
+            frame.End = end;
+            frame.Blocked = blocked;
+            frame.Applied.clear();
+        };
+        push(task.Level, task.Next, task.End, task.Blocked);
+        while (depth > 0 && !cancel.load()) {
+            if (idleWorkers.load(memory_order_relaxed) > 0 && queuedTasks.load(memory_order_relaxed) == 0) {
+                split(stack, depth, board);
+            }
+            Frame& frame = stack[depth - 1];
+            board.undoOption(frame.Applied);
+            if (frame.Level == levels) {
+                leaves.fetch_add(1, memory_order_relaxed);
+                if (board.search(cancel, true) && board.valid()) {
+                    session.publish(board, worker);
+                }
+                depth--;
+                continue;
+            }
+            if (frame.Next >= frame.End) {
+                depth--;
+                continue;
+            }
+            size_t k = frame.Next++;
+            const OptionMask& mask = masks[frame.Level][k];
+            if (mask.Cells.intersects(frame.Blocked)) {
+                continue;
+            }
+            if (!board.addOption(groups[frame.Level][k], frame.Applied)) {
+                continue;
+            }
+            if (!board.countNode(cancel)) {
+                break;
+            }
+            int next = frame.Level + 1;
+            size_t end = next < levels ? groups[next].size() : 0;
+            CellMask blocked = frame.Blocked;
+            blocked |= mask.Blocked;
+            push(next, 0, end, blocked);
+        }
+    };
+
+    auto workerLoop = [&](int worker) {
+        ScratchArena* arena = session.Context.arena(worker);
+        pmr::vector<Frame> stack(arena);
+        try {
+            for (;;) {
+                PrefixTask task;
+                {
+                    TRACE_SPAN("task wait");
+                    unique_lock<mutex> lock(taskMutex);
+                    idle++;
+                    idleWorkers.store(idle);
+                    taskCV.wait(lock, [&]{
+                        return cancel.load() || !tasks.empty() || (rootReady && idle == threads);
+                    });
+                    if (cancel.load() || tasks.empty()) {
+                        taskCV.notify_all();
+                        break;
+                    }
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                    queuedTasks.fetch_sub(1);
+                    idle--;
+                    idleWorkers.store(idle);
+                }
+                runTask(task, stack, arena, worker);
+            }
+        } catch (const exception& e) {
+            cerr << "Exception in prefix tree worker thread: " << e.what() << endl;
+            session.fail();
+        } catch (...) {
+            cerr << "Unknown exception in prefix tree worker thread." << endl;
+            session.fail();
+        }
+        session.workerDone();
+    };
+
+    WorkerPool& pool = session.Context.Pool;
+    for (int t = 0; t < threads; ++t) {
+        session.workerStarted();
+        pool.submit([&workerLoop, t]() { workerLoop(t); });
+    }
+    // The room enumeration runs off the calling thread so the deadline also covers it.
+    GroupEstimate estimate;
+    pool.submit([&]() {
+        try {
+            if (roomGroups(cancel, Sectors, groups, &estimate, &pool, threads)) {
+                levels = static_cast<int>(groups.size());
+                masks = optionMasks(groups, Cells);
+                PrefixTask root{copy(), 0, 0, levels > 0 ? groups[0].size() : 0};
+                session.attach(root.State);
+                root.State.cleanFilled();
+                pushTask(std::move(root));
+            }
+        } catch (const exception& e) {
+            cerr << "Exception in prefix tree generator thread: " << e.what() << endl;
+            session.fail();
+        } catch (...) {
+            cerr << "Unknown exception in prefix tree generator thread." << endl;
+            session.fail();
+        }
+        lock_guard<mutex> lock(taskMutex);
+        rootReady = true;
+        taskCV.notify_all();
+    });
+
+    bool timedOut = session.wait();
+    {
+        lock_guard<mutex> lock(taskMutex);
+        taskCV.notify_all();
+    }
+    pool.wait();
+    session.Result.Stats.Combinations = leaves.load();
+    session.Result.Stats.Splits = splits.load();
+    session.Result.Stats.RawProduct = estimate.RawProduct;
+    session.Result.Stats.PrunedProduct = estimate.PrunedProduct;
+    return session.finish(timedOut);
+}
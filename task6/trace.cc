@@ -0,0 +1,117 @@
+#include "trace.h"
+
+#ifdef HEYAWAKE_TRACE
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+using namespace std;
+
+atomic<bool> traceOn{false};
+
+namespace {
+
+struct TraceEvent {
+    const char* Name = nullptr;
+    uint64_t Begin = 0;
+    uint64_t End = 0;
+    bool Instant = false;
+};
+
+// TraceBuffer is the ring of one thread; Count is the number of events since the trace started,
+// event k is in Events[k % TraceCapacity].
+struct TraceBuffer {
+    int Thread = 0;
+    uint64_t Count = 0;
+    vector<TraceEvent> Events;
+};
+
+// The registry owns the buffers, so they outlive their threads until the dump.
+mutex registryMutex;
+vector<unique_ptr<TraceBuffer>> buffers;
+chrono::steady_clock::time_point traceStart;
+thread_local TraceBuffer* localBuffer = nullptr;
+
+void record(const char* name, uint64_t begin, uint64_t end, bool instant) {
+    if (localBuffer == nullptr) {
+        auto buffer = make_unique<TraceBuffer>();
+        buffer->Events.resize(TraceCapacity);
+        lock_guard<mutex> lock(registryMutex);
+        buffer->Thread = static_cast<int>(buffers.size()) + 1;
+        localBuffer = buffer.get();
+        buffers.push_back(std::move(buffer));
+    }
+    localBuffer->Events[localBuffer->Count++ % TraceCapacity] = TraceEvent{name, begin, end, instant};
+}
+
+}
+
+uint64_t traceClock() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - traceStart).count();
+}
+
+void traceSpan(const char* name, uint64_t begin, uint64_t end) {
+    record(name, begin, end, false);
+}
+
+void traceInstant(const char* name) {
+    if (traceOn.load(memory_order_relaxed)) {
+        uint64_t now = traceClock();
+        record(name, now, now, true);
+    }
+}
+
+void startTrace() {
+    lock_guard<mutex> lock(registryMutex);
+    for (auto& buffer : buffers) {
+        buffer->Count = 0;
+    }
+    traceStart = chrono::steady_clock::now();
+    traceOn.store(true);
+}
+
+void stopTrace() {
+    traceOn.store(false);
+}
+
+// The events are written as complete ("X") and instant ("i") events in microseconds, with a
+// thread_name entry per buffer so the viewer labels the rows.
+bool writeChromeTrace(const string& path) {
+    FILE* out = fopen(path.c_str(), "w");
+    if (out == nullptr) {
+        return false;
+    }
+    lock_guard<mutex> lock(registryMutex);
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    bool first = true;
+    auto separator = [&]() {
+        fprintf(out, first ? "\n" : ",\n");
+        first = false;
+    };
+    for (const auto& buffer : buffers) {
+        if (buffer->Count == 0) {
+            continue;
+        }
+        separator();
+        fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+            buffer->Thread, buffer->Thread);
+        uint64_t from = buffer->Count > TraceCapacity ? buffer->Count - TraceCapacity : 0;
+        for (uint64_t k = from; k < buffer->Count; ++k) {
+            const TraceEvent& event = buffer->Events[k % TraceCapacity];
+            separator();
+            if (event.Instant) {
+                fprintf(out, "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}",
+                    event.Name, buffer->Thread, event.Begin / 1000.0);
+            } else {
+                fprintf(out, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    event.Name, buffer->Thread, event.Begin / 1000.0, (event.End - event.Begin) / 1000.0);
+            }
+        }
+    }
+    fprintf(out, "\n]}\n");
+    return fclose(out) == 0;
+}
+
+#endif
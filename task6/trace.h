@@ -0,0 +1,100 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Solver timeline tracing. Built with -DHEYAWAKE_TRACE (make trace), the solver records spans
+// into a ring buffer per thread while a trace is running, and writeChromeTrace dumps them as
+// Chrome trace JSON for chrome://tracing or ui.perfetto.dev. Without the define the macros
+// expand to nothing, TraceWait is empty and trace.cc compiles to nothing.
+//
+//   TRACE_SPAN("fill");       records the rest of the enclosing scope as a span
+//   TRACE_INSTANT("cancel");  records a point in time
+//   TraceWait wait("idle");   wait.begin() ... wait.end() across loop iterations
+//
+// A thread only writes its own buffer, with no lock and no allocation after its first event.
+// The buffers keep the latest TraceCapacity events of each thread.
+
+#ifdef HEYAWAKE_TRACE
+
+constexpr size_t TraceCapacity = 1u << 16;
+
+// traceOn is read before every event; a relaxed load is all a disabled trace costs.
+extern std::atomic<bool> traceOn;
+
+// traceClock is the time in nanoseconds since the trace started.
+uint64_t traceClock();
+// traceSpan records a span from begin to end, both from traceClock.
+void traceSpan(const char* name, uint64_t begin, uint64_t end);
+void traceInstant(const char* name);
+
+// startTrace clears the buffers and starts recording; stopTrace stops it. Both must be called
+// while no solver thread is running.
+void startTrace();
+void stopTrace();
+// writeChromeTrace writes the recorded events to path; false if the file cannot be written.
+bool writeChromeTrace(const std::string& path);
+
+// TraceScope records its lifetime as a span if a trace was running when it was made.
+class TraceScope {
+    public:
+        explicit TraceScope(const char* name) : name(traceOn.load(std::memory_order_relaxed) ? name : nullptr) {
+            if (this->name != nullptr) {
+                begin = traceClock();
+            }
+        }
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+        ~TraceScope() {
+            if (name != nullptr) {
+                traceSpan(name, begin, traceClock());
+            }
+        }
+
+    private:
+        const char* name;
+        uint64_t begin = 0;
+};
+
+// TraceWait records a wait that spans loop iterations: the time from the first begin to the
+// following end is one span.
+class TraceWait {
+    public:
+        explicit TraceWait(const char* name) : name(name) {}
+        void begin() {
+            if (!open && traceOn.load(std::memory_order_relaxed)) {
+                open = true;
+                start = traceClock();
+            }
+        }
+        void end() {
+            if (open) {
+                open = false;
+                traceSpan(name, start, traceClock());
+            }
+        }
+
+    private:
+        const char* name;
+        bool open = false;
+        uint64_t start = 0;
+};
+
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT2(a, b)
+#define TRACE_SPAN(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_INSTANT(name) traceInstant(name)
+
+#else
+
+struct TraceWait {
+    explicit TraceWait(const char*) {}
+    void begin() {}
+    void end() {}
+};
+
+#define TRACE_SPAN(name) do {} while (false)
+#define TRACE_INSTANT(name) do {} while (false)
+
+#endif
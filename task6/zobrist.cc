@@ -0,0 +1,64 @@
+#include "zobrist.h"
+#include <atomic>
+#include <cstdint>
+using namespace std;
+
+TranspositionTable::TranspositionTable(size_t bytes) {
+    size_t buckets = 1;
+    while (buckets * 2 * BucketSize * sizeof(uint64_t) <= bytes) {
+        buckets *= 2;
+    }
+    slotCount = buckets * BucketSize;
+    bucketMask = buckets - 1;
+    slots = make_unique<atomic<uint64_t>[]>(slotCount);
+    clear();
+}
+
+// Key 0 is the empty slot marker, so it is never stored.
+bool TranspositionTable::contains(uint64_t hash) const {
+    hash ^= salt;
+    if (hash == 0) {
+        return false;
+    }
+    size_t base = (hash & bucketMask) * BucketSize;
+    for (size_t i = 0; i < BucketSize; ++i) {
+        if (slots[base + i].load(memory_order_relaxed) == hash) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// insert takes the first free slot of the bucket, otherwise replaces a slot chosen by the high hash bits.
+void TranspositionTable::insert(uint64_t hash) {
+    hash ^= salt;
+    if (hash == 0) {
+        return;
+    }
+    size_t base = (hash & bucketMask) * BucketSize;
+    for (size_t i = 0; i < BucketSize; ++i) {
+        uint64_t current = slots[base + i].load(memory_order_relaxed);
+        if (current == hash) {
+            return;
+        }
+        if (current == 0 && slots[base + i].compare_exchange_strong(current, hash, memory_order_relaxed)) {
+            return;
+        }
+    }
+    slots[base + (hash >> 62) % BucketSize].store(hash, memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < slotCount; ++i) {
+        slots[i].store(0, memory_order_relaxed);
+    }
+}
+
+void TranspositionTable::nextGeneration() {
+    generation++;
+    salt = zobristKey(-1 - static_cast<int>(generation));
+}
+
+size_t TranspositionTable::capacity() const {
+    return slotCount;
+}
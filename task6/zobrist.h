@@ -0,0 +1,39 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// zobristKey returns the fixed random key of a board cell index.
+// Keys depend only on the index, so every copy of a board hashes the same black cells the same way.
+inline uint64_t zobristKey(int cellIndex) {
+    uint64_t z = static_cast<uint64_t>(cellIndex + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// TranspositionTable is a lossy lock-free set of state hashes that are proven to have no solution.
+// It is shared by all workers; a new entry may overwrite an old one, so a miss never means "alive".
+// Entries are stored xor a per-generation salt, so nextGeneration forgets them all in O(1).
+class TranspositionTable {
+    public:
+        static constexpr size_t DefaultBytes = 16u << 20;
+        static constexpr size_t BucketSize = 4;
+
+        explicit TranspositionTable(size_t bytes = DefaultBytes);
+
+        bool contains(uint64_t hash) const;
+        void insert(uint64_t hash);
+        void clear();
+        // nextGeneration makes every stored entry unreachable; it must not run during a search.
+        void nextGeneration();
+        size_t capacity() const;
+
+    private:
+        std::unique_ptr<std::atomic<uint64_t>[]> slots;
+        size_t slotCount = 0;
+        size_t bucketMask = 0;
+        uint64_t generation = 0;
+        uint64_t salt = 0;
+};